@@ -0,0 +1,243 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include "embedded_ds.h"
+using namespace std;
+
+// Benchmarks - not part of the test suite, build with optimisation:
+//   g++ -O2 bench_embedded_ds.cpp -o bench && ./bench
+
+// Read through a volatile so the compiler cannot fold the buffer size into the code
+// and turn % into a mask behind our back.
+static volatile size_t bench_size = 4096;
+static volatile uint8_t bench_sink;
+
+static double bench_seconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void bench_report(const char *name, size_t bytes, double seconds) {
+    printf("  %-36s %10.1f MB/s\n", name, bytes / seconds / 1e6);
+}
+
+// Per-byte cb_write/cb_read: fill half the buffer, drain it, repeat
+__attribute__((noinline)) static double bench_cb_bytewise(circular_buffer_t *cb, size_t total) {
+    size_t chunk = cb->size / 2;
+    uint8_t data = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t done = 0; done < total; done += chunk) {
+        for (size_t i = 0; i < chunk; i++) {
+            cb_write(cb, (uint8_t)i);
+        }
+        for (size_t i = 0; i < chunk; i++) {
+            cb_read(cb, &data);
+        }
+    }
+    bench_sink = data;
+    return bench_seconds(start);
+}
+
+// Bulk cb_write_n/cb_read_n with the same access pattern (chunk sizes force wraps)
+__attribute__((noinline)) static double bench_cb_bulk(circular_buffer_t *cb, size_t total) {
+    uint8_t chunk[1500];
+    auto start = chrono::steady_clock::now();
+    for (size_t done = 0; done < total; done += sizeof(chunk)) {
+        cb_write_n(cb, chunk, sizeof(chunk));
+        cb_read_n(cb, chunk, sizeof(chunk));
+    }
+    bench_sink = chunk[0];
+    return bench_seconds(start);
+}
+
+void bench_circular_buffer() {
+    cout << "Circular Buffer (default % mode vs power-of-two mode):\n";
+
+    static uint8_t storage[4096];
+    const size_t total = 256u << 20;
+    circular_buffer_t cb;
+
+    cb_init(&cb, storage, bench_size);
+    bench_report("cb_write/cb_read, default", total, bench_cb_bytewise(&cb, total));
+    cb_init_pow2(&cb, storage, bench_size);
+    bench_report("cb_write/cb_read, pow2", total, bench_cb_bytewise(&cb, total));
+
+    cb_init(&cb, storage, bench_size);
+    bench_report("cb_write_n/cb_read_n, default", total, bench_cb_bulk(&cb, total));
+    cb_init_pow2(&cb, storage, bench_size);
+    bench_report("cb_write_n/cb_read_n, pow2", total, bench_cb_bulk(&cb, total));
+}
+
+// One producer thread, one consumer thread streaming through the lock-free SPSC buffer.
+// Compare layouts by building once as-is and once with -DSPSC_PACKED_LAYOUT.
+void bench_spsc_buffer() {
+#ifdef SPSC_PACKED_LAYOUT
+    cout << "SPSC Buffer (packed layout, " << sizeof(spsc_buffer_t) << " bytes):\n";
+#else
+    cout << "SPSC Buffer (cache-line padded layout, " << sizeof(spsc_buffer_t) << " bytes):\n";
+#endif
+    cout << "  hardware threads: " << thread::hardware_concurrency() << "\n";
+
+    static uint8_t storage[4096];
+    const size_t total = 64u << 20;
+    spsc_buffer_t sb;
+    spsc_init(&sb, storage, bench_size);
+
+    auto start = chrono::steady_clock::now();
+    thread producer([&sb, total]() {
+        for (size_t i = 0; i < total; i++) {
+            while (!spsc_write(&sb, (uint8_t)i)) {
+                this_thread::yield();
+            }
+        }
+    });
+    uint8_t data = 0;
+    for (size_t i = 0; i < total; i++) {
+        while (!spsc_read(&sb, &data)) {
+            this_thread::yield();
+        }
+    }
+    producer.join();
+    bench_sink = data;
+    bench_report("spsc_write/spsc_read, 2 threads", total, bench_seconds(start));
+}
+
+// Every thread does enqueue-then-dequeue pairs, so the queue never runs dry and the
+// numbers show contention only. Baseline: circular_buffer_t behind one mutex.
+template <typename Op>
+static double bench_threads(int threads, size_t ops_per_thread, Op op) {
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&op, t, ops_per_thread]() {
+            for (size_t i = 0; i < ops_per_thread; i++) {
+                op(t, i);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    return bench_seconds(start);
+}
+
+void bench_mpmc_queue() {
+    cout << "MPMC Queue (Mops/s, one op = one element in and out):\n";
+    printf("  %-8s %12s %12s %12s\n", "threads", "mutex+cb", "mpmc", "mpmc x16");
+
+    static uint8_t memory[1 << 16];
+    static uint8_t cb_storage[4096];
+    const size_t total = 1u << 21;
+    const int counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    for (int threads : counts) {
+        size_t per_thread = total / threads;
+        double rate[3];
+
+        circular_buffer_t cb;
+        cb_init(&cb, cb_storage, sizeof(cb_storage));
+        mutex lock;
+        rate[0] = total / bench_threads(threads, per_thread, [&](int t, size_t i) {
+            uint32_t value = (uint32_t)(t + i);
+            lock_guard<mutex> guard(lock);
+            cb_write_n(&cb, (uint8_t *)&value, sizeof(value));
+            cb_read_n(&cb, (uint8_t *)&value, sizeof(value));
+        }) / 1e6;
+
+        mpmc_queue_t q;
+        mpmc_init(&q, memory, 1024, sizeof(uint32_t));
+        rate[1] = total / bench_threads(threads, per_thread, [&q](int t, size_t i) {
+            uint32_t value = (uint32_t)(t + i);
+            while (!mpmc_enqueue(&q, &value)) {
+                this_thread::yield();
+            }
+            while (!mpmc_dequeue(&q, &value)) {
+                this_thread::yield();
+            }
+        }) / 1e6;
+
+        mpmc_init(&q, memory, 1024, sizeof(uint32_t));
+        rate[2] = total / bench_threads(threads, per_thread / 16, [&q](int t, size_t i) {
+            uint32_t values[16];
+            for (size_t k = 0; k < 16; k++) {
+                values[k] = (uint32_t)(t + i + k);
+            }
+            for (size_t done = 0; done < 16; ) {
+                size_t moved = mpmc_enqueue_n(&q, values + done, 16 - done);
+                if (moved == 0) {
+                    this_thread::yield();
+                }
+                done += moved;
+            }
+            for (size_t done = 0; done < 16; ) {
+                size_t moved = mpmc_dequeue_n(&q, values + done, 16 - done);
+                if (moved == 0) {
+                    this_thread::yield();
+                }
+                done += moved;
+            }
+        }) / 1e6;
+
+        printf("  %-8d %12.1f %12.1f %12.1f\n", threads, rate[0], rate[1], rate[2]);
+    }
+}
+
+// Scheduler-shaped load: every thread pushes a task and takes one back. With one global
+// MPMC queue all threads meet on the same two positions; with one work-stealing deque per
+// thread the owner path stays uncontended and every 8th take is a steal from the next
+// thread's deque (falling back to the own deque when there is nothing to steal).
+void bench_ws_deque() {
+    cout << "Work-Stealing Deque (Mops/s, one op = one task in and out):\n";
+    printf("  %-8s %12s %12s\n", "threads", "global mpmc", "ws_deque");
+
+    static uint8_t memory[1 << 14];
+    static void *slots[64][256];
+    static ws_deque_t deques[64];
+    const size_t total = 1u << 21;
+    const int counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    for (int threads : counts) {
+        size_t per_thread = total / threads;
+        double rate[2];
+
+        mpmc_queue_t q;
+        mpmc_init(&q, memory, 1024, sizeof(void *));
+        rate[0] = total / bench_threads(threads, per_thread, [&q](int t, size_t i) {
+            void *task = (void *)(uintptr_t)(t + i);
+            while (!mpmc_enqueue(&q, &task)) {
+                this_thread::yield();
+            }
+            while (!mpmc_dequeue(&q, &task)) {
+                this_thread::yield();
+            }
+        }) / 1e6;
+
+        for (int t = 0; t < threads; t++) {
+            wsd_init(&deques[t], slots[t], 256);
+        }
+        rate[1] = total / bench_threads(threads, per_thread, [threads](int t, size_t i) {
+            void *task = (void *)(uintptr_t)(t + i);
+            wsd_push(&deques[t], task);  // Full: the task would run inline
+            if ((i & 7) == 7 && wsd_steal(&deques[(t + 1) % threads], &task)) {
+                return;
+            }
+            wsd_pop(&deques[t], &task);
+            bench_sink = (uint8_t)(uintptr_t)task;
+        }) / 1e6;
+
+        printf("  %-8d %12.1f %12.1f\n", threads, rate[0], rate[1]);
+    }
+}
+
+int main() {
+    cout << "Benchmarking Embedded Data Structures...\n\n";
+
+    bench_circular_buffer();
+    bench_spsc_buffer();
+    bench_mpmc_queue();
+    bench_ws_deque();
+
+    return 0;
+}
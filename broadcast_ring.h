@@ -0,0 +1,152 @@
+// Broadcast Ring = single writer, many readers, every reader sees every event
+// (disruptor style). Instead of copying each event into one circular_buffer_t per
+// subscriber, the event is written once and each reader walks the same slots with its
+// own cursor. The writer may only reuse a slot once the slowest reader has moved past
+// it, so a slow reader applies backpressure instead of losing events.
+// Events are fixed-size (element_size bytes) and live in caller-provided memory; the
+// per-reader cursors are also caller-provided (one bc_reader_t per subscriber).
+// Sequence numbers are free-running 64-bit counters, the slot is (sequence & mask).
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+using namespace std;
+
+#ifndef BC_CACHE_LINE_SIZE
+#define BC_CACHE_LINE_SIZE 64
+#endif
+
+// One per reader, each on its own cache line - only that reader stores to it
+typedef struct {
+    alignas(BC_CACHE_LINE_SIZE) uint64_t cursor;  // Next sequence this reader will read
+} bc_reader_t;
+
+typedef struct {
+    // Read-only after init
+    uint8_t *memory;        // capacity * element_size bytes
+    size_t capacity;        // Number of slots - power of two
+    size_t mask;            // capacity - 1
+    size_t element_size;    // Size of each event (bytes)
+    bc_reader_t *readers;   // Caller-provided cursor array
+    size_t num_readers;
+
+    // Writer-owned line
+    alignas(BC_CACHE_LINE_SIZE) uint64_t published;  // Events < published are readable
+    uint64_t gate;          // Writer's cached minimum of the reader cursors
+} broadcast_ring_t;
+
+// Function Declarations:
+// capacity must be a power of two (>= 2), returns false otherwise
+static inline bool bc_init(broadcast_ring_t *bc, uint8_t *memory, size_t capacity, size_t element_size,
+                           bc_reader_t *readers, size_t num_readers);
+// Writer: claim the next slot (NULL when the slowest reader is a full lap behind),
+// fill it in place, then publish it to every reader at once
+static inline void* bc_claim(broadcast_ring_t *bc);
+static inline void bc_publish(broadcast_ring_t *bc);
+static inline bool bc_write(broadcast_ring_t *bc, const void *event);
+// Reader r: look at the next event in place (NULL when caught up), then advance past n
+// events (false, cursor unchanged, if fewer than n are published)
+static inline const void* bc_peek(broadcast_ring_t *bc, size_t r);
+static inline bool bc_advance(broadcast_ring_t *bc, size_t r, size_t n);
+static inline bool bc_read(broadcast_ring_t *bc, size_t r, void *event);
+// Events reader r has not read yet
+static inline size_t bc_available(broadcast_ring_t *bc, size_t r);
+
+// Helper Functions:
+static inline uint8_t *bc_slot(broadcast_ring_t *bc, uint64_t sequence) {
+    return bc->memory + (size_t)(sequence & bc->mask) * bc->element_size;
+}
+
+// Slowest reader's cursor - only called by the writer when its cached gate says full
+static inline uint64_t bc_min_cursor(broadcast_ring_t *bc) {
+    uint64_t min = bc->published;
+    for (size_t i = 0; i < bc->num_readers; i++) {
+        uint64_t cursor = __atomic_load_n(&bc->readers[i].cursor, __ATOMIC_ACQUIRE);
+        if (cursor < min) {
+            min = cursor;
+        }
+    }
+    return min;
+}
+
+// Function Implementations:
+// Must be called before the writer and reader threads start.
+static inline bool bc_init(broadcast_ring_t *bc, uint8_t *memory, size_t capacity, size_t element_size,
+                           bc_reader_t *readers, size_t num_readers) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return false;  // Not a power of two
+    }
+    bc->memory = memory;
+    bc->capacity = capacity;
+    bc->mask = capacity - 1;
+    bc->element_size = element_size;
+    bc->readers = readers;
+    bc->num_readers = num_readers;
+    bc->published = 0;
+    bc->gate = 0;
+    for (size_t i = 0; i < num_readers; i++) {
+        readers[i].cursor = 0;
+    }
+    return true;
+}
+
+static inline void* bc_claim(broadcast_ring_t *bc) {
+    if (bc->published - bc->gate >= bc->capacity) {
+        bc->gate = bc_min_cursor(bc);  // Only scan the readers when the cache says full
+        if (bc->published - bc->gate >= bc->capacity) {
+            return NULL;
+        }
+    }
+    return bc_slot(bc, bc->published);
+}
+
+// Release: the event contents become visible together with the new sequence.
+static inline void bc_publish(broadcast_ring_t *bc) {
+    __atomic_store_n(&bc->published, bc->published + 1, __ATOMIC_RELEASE);
+}
+
+static inline bool bc_write(broadcast_ring_t *bc, const void *event) {
+    void *slot = bc_claim(bc);
+    if (slot == NULL) {
+        return false;
+    }
+    memcpy(slot, event, bc->element_size);
+    bc_publish(bc);
+    return true;
+}
+
+static inline size_t bc_available(broadcast_ring_t *bc, size_t r) {
+    uint64_t published = __atomic_load_n(&bc->published, __ATOMIC_ACQUIRE);
+    return (size_t)(published - bc->readers[r].cursor);
+}
+
+static inline const void* bc_peek(broadcast_ring_t *bc, size_t r) {
+    if (bc_available(bc, r) == 0) {
+        return NULL;
+    }
+    return bc_slot(bc, bc->readers[r].cursor);
+}
+
+// Release: the writer may reuse the slots we moved past only after we finished with them.
+static inline bool bc_advance(broadcast_ring_t *bc, size_t r, size_t n) {
+    if (n > bc_available(bc, r)) {
+        return false;  // Past the writer: the reader would see unpublished slots
+    }
+    __atomic_store_n(&bc->readers[r].cursor, bc->readers[r].cursor + n, __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline bool bc_read(broadcast_ring_t *bc, size_t r, void *event) {
+    const void *slot = bc_peek(bc, r);
+    if (slot == NULL) {
+        return false;
+    }
+    memcpy(event, slot, bc->element_size);
+    bc_advance(bc, r, 1);
+    return true;
+}
+
+#endif
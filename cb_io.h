@@ -0,0 +1,111 @@
+// File descriptor I/O straight into / out of a circular buffer (POSIX).
+// Instead of read(2) into a scratch array followed by cb_write_n, cb_fill_from_fd hands
+// the buffer's free region(s) to readv and commits whatever arrived; cb_drain_to_fd hands
+// the waiting region(s) to writev and consumes whatever was sent. One syscall moves as
+// much as fits, even across the wrap point, with no intermediate copy.
+// Works with blocking and non-blocking fds (sockets, pipes, serial ports, files).
+// Return values follow read/write: bytes moved, 0 for end-of-file (fill only) or nothing
+// to send (drain), -1 with errno set on error. EINTR is retried internally; EAGAIN /
+// EWOULDBLOCK come back as -1 so an event loop can wait for readiness. A full buffer
+// makes cb_fill_from_fd fail with ENOBUFS rather than return 0, so it cannot be
+// mistaken for end-of-file. Indices only move by what the kernel actually transferred.
+#ifndef CB_IO_H
+#define CB_IO_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+#include "circular_buffer.h"
+using namespace std;
+
+// Function Declarations:
+static inline ssize_t cb_fill_from_fd(circular_buffer_t *cb, int fd);
+static inline ssize_t cb_drain_to_fd(circular_buffer_t *cb, int fd);
+
+#ifdef __linux__
+// Watermark crossings as eventfd signals, for producers that sit in poll/epoll: pass
+// cb_watermark_eventfd and a cb_watermark_fds_t to cb_set_watermarks. Each crossing adds
+// 1 to the matching eventfd (-1 skips that event).
+typedef struct {
+    int high_fd;  // Signalled when the fill level reaches the high mark - back off
+    int low_fd;   // Signalled when it falls back to the low mark - resume
+} cb_watermark_fds_t;
+
+static inline void cb_watermark_eventfd(void *ctx, int event);
+#endif
+
+// Helper Functions:
+// Turns up to two regions into an iovec array, skipping an empty second region
+static inline int cb_io_vectors(cb_region_t regions[2], struct iovec iov[2]) {
+    int count = 0;
+    for (int r = 0; r < 2; r++) {
+        if (regions[r].len > 0) {
+            iov[count].iov_base = regions[r].data;
+            iov[count].iov_len = regions[r].len;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Function Implementations:
+static inline ssize_t cb_fill_from_fd(circular_buffer_t *cb, int fd) {
+    cb_region_t regions[2];
+    struct iovec iov[2];
+    if (cb_write_reserve(cb, regions) == 0) {
+        errno = ENOBUFS;
+        return -1;
+    }
+    int count = cb_io_vectors(regions, iov);
+
+    ssize_t n;
+    do {
+        n = readv(fd, iov, count);
+    } while (n < 0 && errno == EINTR);
+
+    if (n > 0) {
+        cb_write_commit(cb, (size_t)n);  // Partial reads commit just what arrived
+    }
+    return n;
+}
+
+static inline ssize_t cb_drain_to_fd(circular_buffer_t *cb, int fd) {
+    cb_region_t regions[2];
+    struct iovec iov[2];
+    if (cb_read_peek(cb, regions) == 0) {
+        return 0;  // Nothing waiting
+    }
+    int count = cb_io_vectors(regions, iov);
+
+    ssize_t n;
+    do {
+        n = writev(fd, iov, count);
+    } while (n < 0 && errno == EINTR);
+
+    if (n > 0) {
+        cb_read_consume(cb, (size_t)n);  // Partial writes keep the rest for next time
+    }
+    return n;
+}
+
+#ifdef __linux__
+static inline void cb_watermark_eventfd(void *ctx, int event) {
+    cb_watermark_fds_t *fds = (cb_watermark_fds_t *)ctx;
+    int fd = (event == CB_WATERMARK_HIGH) ? fds->high_fd : fds->low_fd;
+    if (fd >= 0) {
+        eventfd_write(fd, 1);  // Only fails if the counter would overflow
+    }
+}
+#endif
+
+#endif // __unix__ || __APPLE__
+
+#endif
@@ -0,0 +1,125 @@
+// Delimiter search over the waiting data of a circular buffer, without consuming it.
+// Line- and frame-based protocols need to find '\n' or 0x7E markers in the ring; doing
+// that with cb_read byte by byte copies everything out first. These functions look at
+// the readable region(s) in place (cb_read_peek) and compare 32 (AVX2) or 16 (SSE2)
+// bytes per step, with a plain byte loop on other targets and for the leftover bytes.
+// The SIMD width is picked at compile time (-mavx2 enables the AVX2 path).
+// Returned offsets count from the oldest waiting byte, so the caller can cb_read_n or
+// cb_read_consume exactly up to (and including) the delimiter.
+#ifndef CB_SCAN_H
+#define CB_SCAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "circular_buffer.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// Sets up to this size are searched with SIMD compares, larger ones with a lookup table
+#ifndef CB_SCAN_MAX_SET
+#define CB_SCAN_MAX_SET 16
+#endif
+
+// Function Declarations:
+// Offset of the first occurrence of byte - false if it is not in the buffer
+static inline bool cb_find(circular_buffer_t *cb, uint8_t byte, size_t *offset);
+// Offset of the first byte that matches any of set[0..set_len) - for small sets
+static inline bool cb_find_any(circular_buffer_t *cb, const uint8_t *set, size_t set_len, size_t *offset);
+
+// Helper Functions:
+static inline bool cb_scan_is_member(uint8_t value, const uint8_t *set, size_t set_len) {
+    for (size_t k = 0; k < set_len; k++) {
+        if (value == set[k]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Index of the first byte of data[0..len) in the set, or len if there is none.
+// The set is broadcast into vector registers once, before the scan loop.
+static inline size_t cb_scan_span(const uint8_t *data, size_t len, const uint8_t *set, size_t set_len) {
+    size_t i = 0;
+    if (set_len > CB_SCAN_MAX_SET) {
+        // Large sets: one table lookup per byte beats set_len compares per chunk
+        bool member[256] = {false};
+        for (size_t k = 0; k < set_len; k++) {
+            member[set[k]] = true;
+        }
+        for (; i < len; i++) {
+            if (member[data[i]]) {
+                return i;
+            }
+        }
+        return len;
+    }
+#if defined(__AVX2__)
+    __m256i needles[CB_SCAN_MAX_SET];
+    for (size_t k = 0; k < set_len; k++) {
+        needles[k] = _mm256_set1_epi8((char)set[k]);
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i hits = _mm256_setzero_si256();
+        for (size_t k = 0; k < set_len; k++) {
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, needles[k]));
+        }
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(hits);  // One bit per matching byte
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i needles[CB_SCAN_MAX_SET];
+    for (size_t k = 0; k < set_len; k++) {
+        needles[k] = _mm_set1_epi8((char)set[k]);
+    }
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i hits = _mm_setzero_si128();
+        for (size_t k = 0; k < set_len; k++) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, needles[k]));
+        }
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+#endif
+    // Scalar fallback / leftover bytes
+    for (; i < len; i++) {
+        if (cb_scan_is_member(data[i], set, set_len)) {
+            return i;
+        }
+    }
+    return len;
+}
+
+// Function Implementations:
+static inline bool cb_find(circular_buffer_t *cb, uint8_t byte, size_t *offset) {
+    return cb_find_any(cb, &byte, 1, offset);
+}
+
+// Scans the part before the wrap point first, then the part after it.
+static inline bool cb_find_any(circular_buffer_t *cb, const uint8_t *set, size_t set_len, size_t *offset) {
+    cb_region_t regions[2];
+    cb_read_peek(cb, regions);
+
+    size_t base = 0;
+    for (int r = 0; r < 2; r++) {
+        size_t index = cb_scan_span(regions[r].data, regions[r].len, set, set_len);
+        if (index < regions[r].len) {
+            *offset = base + index;
+            return true;
+        }
+        base += regions[r].len;
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,368 @@
+// io_uring pump - keeps several reads in flight into the free space of a circular buffer
+// without blocking a thread per read (Linux 5.5+, talks to the kernel through the raw
+// io_uring syscalls, so no liburing is needed).
+// The free space past cb->head is cut into chunk-sized pieces (never across the wrap
+// point) and one READV per piece is queued; all of them go to the kernel with a single
+// io_uring_enter. Completions may arrive in any order, but bytes are only committed to
+// the buffer in submission order, so the consumer sees one contiguous stream.
+// - Regular files: every read carries its own file offset and they all run in parallel.
+//   The fd's file position is not moved.
+// - Pipes, sockets, character devices: reads are linked (IOSQE_IO_LINK) so the kernel
+//   runs them one after another; a short read cancels the rest of the chain and the next
+//   pump starts a new one from where the data stopped.
+// The pump owns the producer side of the buffer: the same thread reads from cb between
+// pumps, nothing else writes to it, and overwrite mode is not supported.
+#ifndef CB_URING_H
+#define CB_URING_H
+
+#ifdef __linux__
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CB_URING_AVAILABLE 1
+#endif
+#endif
+#endif
+
+#ifdef CB_URING_AVAILABLE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "circular_buffer.h"
+using namespace std;
+
+#define CB_URING_MAX_DEPTH 64                // Upper bound on reads in flight
+#define CB_URING_CANCEL_TAG 0xFFFFFFFFFFFFFFFFull  // user_data of cancel requests
+
+// One queued read, indexed by its user_data
+typedef struct {
+    struct iovec iov;  // Piece of the buffer this read fills
+    uint64_t offset;   // File offset (regular files only)
+    int32_t result;    // Bytes read or -errno once done
+    bool done;
+} cb_uring_read_t;
+
+typedef struct {
+    circular_buffer_t *cb;
+    int fd;            // Source descriptor
+    int ring_fd;       // io_uring instance
+    bool seekable;     // Regular file: explicit offsets, reads run in parallel
+    uint64_t offset;   // Next file offset to request
+    size_t chunk;      // Largest single read
+    unsigned depth;    // Most reads in flight at once
+    size_t reserved;   // Bytes past cb->head promised to reads in flight
+    bool resync;       // A short read happened - let the stale reads drain before submitting
+    bool eof;
+    int error;         // errno of the first failed read, 0 if none
+
+    // Rings shared with the kernel
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;
+    size_t cq_map_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    // Reads in flight, in submission order
+    cb_uring_read_t reads[CB_URING_MAX_DEPTH];
+    unsigned first;
+    unsigned inflight;
+} cb_uring_t;
+
+// Function Declarations:
+// Sets up an io_uring with room for depth reads of at most chunk bytes each. Returns false
+// (errno set) when io_uring is unavailable, e.g. an old kernel or a seccomp filter.
+static inline bool cb_uring_init(cb_uring_t *u, circular_buffer_t *cb, int fd, unsigned depth, size_t chunk);
+// Cancels and waits out the reads still in flight, then releases the io_uring
+static inline void cb_uring_destroy(cb_uring_t *u);
+// Commits finished reads, queues new ones into the free space and submits them. With wait,
+// blocks until at least one read completes. Returns the bytes committed by this call, or
+// -1 with errno set once a read has failed and nothing was committed.
+static inline ssize_t cb_uring_pump(cb_uring_t *u, bool wait);
+// End of file (or an error) reached and every read in flight has been retired
+static inline bool cb_uring_finished(cb_uring_t *u);
+
+// Helper Functions:
+static inline int cb_uring_enter(cb_uring_t *u, unsigned to_submit, unsigned min_complete) {
+    unsigned flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+    return (int)syscall(__NR_io_uring_enter, u->ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// Queues one SQE; the caller publishes the new SQ tail
+static inline struct io_uring_sqe *cb_uring_next_sqe(cb_uring_t *u, unsigned tail) {
+    unsigned index = tail & *u->sq_mask;
+    struct io_uring_sqe *sqe = &u->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    u->sq_array[index] = index;
+    return sqe;
+}
+
+// Cuts the free space past what is already promised into reads. Returns how many were queued.
+static inline unsigned cb_uring_queue_reads(cb_uring_t *u) {
+    if (u->eof || u->error != 0 || u->resync) {
+        return 0;
+    }
+    if (!u->seekable && u->inflight > 0) {
+        return 0;  // Streams: one linked chain at a time, or data could arrive out of order
+    }
+
+    cb_region_t regions[2];
+    cb_write_reserve(u->cb, regions);
+    size_t skip = u->reserved;
+    unsigned tail = *u->sq_tail;  // Only this thread moves the SQ tail
+    unsigned queued = 0;
+    struct io_uring_sqe *prev = NULL;
+
+    for (int r = 0; r < 2 && u->inflight < u->depth; r++) {
+        if (skip >= regions[r].len) {
+            skip -= regions[r].len;
+            continue;
+        }
+        uint8_t *data = regions[r].data + skip;
+        size_t len = regions[r].len - skip;
+        skip = 0;
+
+        while (len > 0 && u->inflight < u->depth) {
+            size_t n = (len < u->chunk) ? len : u->chunk;
+            unsigned slot = (u->first + u->inflight) % CB_URING_MAX_DEPTH;
+            cb_uring_read_t *rd = &u->reads[slot];
+            rd->iov.iov_base = data;
+            rd->iov.iov_len = n;
+            rd->offset = u->offset;
+            rd->done = false;
+
+            struct io_uring_sqe *sqe = cb_uring_next_sqe(u, tail++);
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = u->fd;
+            sqe->addr = (uint64_t)(uintptr_t)&rd->iov;
+            sqe->len = 1;
+            sqe->off = u->seekable ? u->offset : (uint64_t)-1;
+            sqe->user_data = slot;
+            if (prev != NULL && !u->seekable) {
+                prev->flags |= IOSQE_IO_LINK;  // Run after the previous read, cancelled if it comes up short
+            }
+            prev = sqe;
+
+            if (u->seekable) {
+                u->offset += n;
+            }
+            u->reserved += n;
+            u->inflight++;
+            queued++;
+            data += n;
+            len -= n;
+        }
+    }
+    // Release: the SQEs are complete before the kernel can see the new tail
+    __atomic_store_n(u->sq_tail, tail, __ATOMIC_RELEASE);
+    return queued;
+}
+
+// Moves completions out of the CQ into the read records
+static inline void cb_uring_reap(cb_uring_t *u) {
+    unsigned head = *u->cq_head;
+    unsigned tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        struct io_uring_cqe *cqe = &u->cqes[head & *u->cq_mask];
+        if (cqe->user_data != CB_URING_CANCEL_TAG) {
+            cb_uring_read_t *rd = &u->reads[cqe->user_data];
+            rd->result = cqe->res;
+            rd->done = true;
+        }
+        head++;
+    }
+    __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+}
+
+// Commits finished reads from the oldest on, stopping at the first one still in flight
+static inline size_t cb_uring_retire(cb_uring_t *u) {
+    size_t committed = 0;
+    while (u->inflight > 0 && u->reads[u->first].done) {
+        cb_uring_read_t *rd = &u->reads[u->first];
+        size_t len = rd->iov.iov_len;
+        if (!u->resync) {
+            if (rd->result > 0) {
+                cb_write_commit(u->cb, (size_t)rd->result);
+                committed += (size_t)rd->result;
+            } else if (rd->result == 0) {
+                u->eof = true;
+            } else {
+                u->error = -rd->result;
+            }
+            if (rd->result != (int32_t)len) {
+                // Later reads were cancelled (streams) or landed after a gap (files): drop
+                // them and continue from where this one stopped
+                u->resync = true;
+                u->offset = rd->offset + (uint64_t)(rd->result > 0 ? rd->result : 0);
+            }
+        }
+        u->reserved -= len;
+        u->first = (u->first + 1) % CB_URING_MAX_DEPTH;
+        u->inflight--;
+    }
+    if (u->inflight == 0) {
+        u->resync = false;
+    }
+    return committed;
+}
+
+// Function Implementations:
+static inline bool cb_uring_init(cb_uring_t *u, circular_buffer_t *cb, int fd, unsigned depth, size_t chunk) {
+    if (cb->overwrite || depth == 0 || depth > CB_URING_MAX_DEPTH || chunk == 0) {
+        errno = EINVAL;
+        return false;
+    }
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int ring_fd = (int)syscall(__NR_io_uring_setup, depth, &p);
+    if (ring_fd < 0) {
+        return false;
+    }
+
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        sq_size = cq_size = (sq_size > cq_size) ? sq_size : cq_size;  // One mapping holds both rings
+    }
+    void *sq_map = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    void *cq_map = single ? sq_map
+                          : mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    size_t sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sq_map == MAP_FAILED || cq_map == MAP_FAILED || sqes == MAP_FAILED) {
+        int saved = errno;
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        if (!single && cq_map != MAP_FAILED) munmap(cq_map, cq_size);
+        if (sq_map != MAP_FAILED) munmap(sq_map, sq_size);
+        close(ring_fd);
+        errno = saved;
+        return false;
+    }
+
+    struct stat st;
+    memset(u, 0, sizeof(*u));
+    u->cb = cb;
+    u->fd = fd;
+    u->ring_fd = ring_fd;
+    u->seekable = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (u->seekable) {
+        off_t position = lseek(fd, 0, SEEK_CUR);  // Start where the caller left the file
+        u->offset = (position > 0) ? (uint64_t)position : 0;
+    }
+    u->chunk = chunk;
+    u->depth = depth;
+    u->sq_map = sq_map;
+    u->sq_map_size = sq_size;
+    u->cq_map = cq_map;
+    u->cq_map_size = single ? 0 : cq_size;
+    u->sqes = (struct io_uring_sqe *)sqes;
+    u->sqes_size = sqes_size;
+    u->sq_tail = (unsigned *)((uint8_t *)sq_map + p.sq_off.tail);
+    u->sq_mask = (unsigned *)((uint8_t *)sq_map + p.sq_off.ring_mask);
+    u->sq_array = (unsigned *)((uint8_t *)sq_map + p.sq_off.array);
+    u->cq_head = (unsigned *)((uint8_t *)cq_map + p.cq_off.head);
+    u->cq_tail = (unsigned *)((uint8_t *)cq_map + p.cq_off.tail);
+    u->cq_mask = (unsigned *)((uint8_t *)cq_map + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe *)((uint8_t *)cq_map + p.cq_off.cqes);
+    return true;
+}
+
+// Waits for the cancellations too, so the kernel never writes into the buffer afterwards.
+static inline void cb_uring_destroy(cb_uring_t *u) {
+    if (u->inflight > 0) {
+        unsigned tail = *u->sq_tail;
+        for (unsigned k = 0; k < u->inflight; k++) {
+            unsigned slot = (u->first + k) % CB_URING_MAX_DEPTH;
+            if (!u->reads[slot].done) {
+                struct io_uring_sqe *sqe = cb_uring_next_sqe(u, tail++);
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->addr = slot;  // user_data of the read to cancel
+                sqe->user_data = CB_URING_CANCEL_TAG;
+            }
+        }
+        unsigned queued = tail - *u->sq_tail;
+        __atomic_store_n(u->sq_tail, tail, __ATOMIC_RELEASE);
+        while (queued > 0) {
+            int ret = cb_uring_enter(u, queued, 0);
+            if (ret < 0 && errno != EINTR) {
+                break;
+            }
+            queued -= (ret > 0) ? (unsigned)ret : 0;
+        }
+
+        for (;;) {
+            cb_uring_reap(u);
+            bool pending = false;
+            for (unsigned k = 0; k < u->inflight; k++) {
+                pending = pending || !u->reads[(u->first + k) % CB_URING_MAX_DEPTH].done;
+            }
+            if (!pending || (cb_uring_enter(u, 0, 1) < 0 && errno != EINTR)) {
+                break;
+            }
+        }
+    }
+
+    munmap(u->sqes, u->sqes_size);
+    if (u->cq_map_size > 0) {
+        munmap(u->cq_map, u->cq_map_size);
+    }
+    munmap(u->sq_map, u->sq_map_size);
+    close(u->ring_fd);
+    u->ring_fd = -1;
+    u->inflight = 0;
+}
+
+static inline ssize_t cb_uring_pump(cb_uring_t *u, bool wait) {
+    cb_uring_reap(u);
+    size_t committed = cb_uring_retire(u);
+
+    unsigned queued = cb_uring_queue_reads(u);
+    unsigned min_complete = (wait && committed == 0 && u->inflight > 0) ? 1 : 0;
+    // One io_uring_enter submits the whole batch and (optionally) waits
+    while (queued > 0 || min_complete > 0) {
+        int ret = cb_uring_enter(u, queued, min_complete);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        queued -= (unsigned)ret;
+        min_complete = 0;
+    }
+
+    cb_uring_reap(u);
+    committed += cb_uring_retire(u);
+    if (committed == 0 && u->error != 0) {
+        errno = u->error;
+        return -1;
+    }
+    return (ssize_t)committed;
+}
+
+static inline bool cb_uring_finished(cb_uring_t *u) {
+    return (u->eof || u->error != 0) && u->inflight == 0;
+}
+
+#endif // CB_URING_AVAILABLE
+
+#endif
@@ -9,8 +9,14 @@
 #include <stdint.h>
 #include <stdbool.h> 
 #include <stddef.h>
+#include <string.h>
 using namespace std;
 
+// Watermark events - the fill level went up to high_mark, or back down to low_mark
+#define CB_WATERMARK_HIGH 1
+#define CB_WATERMARK_LOW 0
+typedef void (*cb_watermark_fn)(void *ctx, int event);
+
 // Struct defined here:
 typedef struct {
     uint8_t *buffer;   // Pointer to buffer/data storage
@@ -18,12 +24,38 @@ typedef struct {
     size_t head;       // Write Index
     size_t tail;       // Read Index
     size_t count;      // Number of elements currently in buffer
+    size_t mask;       // size - 1 in power-of-two mode, 0 in the default mode
+    bool overwrite;    // Overwrite mode: writes to a full buffer drop the oldest data
+    size_t dropped;    // Bytes lost to overwrite mode since init
+    size_t high_mark;  // Fill level that fires CB_WATERMARK_HIGH (SIZE_MAX = watermarks off)
+    size_t low_mark;   // Fill level that fires CB_WATERMARK_LOW after a high crossing
+    bool above_high;   // High crossing reported, low crossing not yet
+    size_t write_limit;  // cb_write leaves its fast path at this fill level (size when no mark is armed)
+    size_t read_limit;   // cb_read leaves its fast path at this fill level (0 when no mark is armed)
+    cb_watermark_fn on_watermark;  // Called once per crossing
+    void *watermark_ctx;
 
 } circular_buffer_t;
 
+// One contiguous piece of the buffer's own storage, handed out by the zero-copy calls.
+// Free space and waiting data can both wrap, so they come as up to two of these.
+typedef struct {
+    uint8_t *data;  // Points into the caller-provided storage
+    size_t len;     // 0 when the piece is unused
+} cb_region_t;
+
 // Function Declarations:
 // Core functionality - to initialize the buffer
 static inline void cb_init(circular_buffer_t *cb, uint8_t *buffer, size_t size);
+// Power-of-two mode - size must be a power of two (>= 2), returns false otherwise
+static inline bool cb_init_pow2(circular_buffer_t *cb, uint8_t *buffer, size_t size);
+// Overwrite (lossy) mode - keep the newest data instead of rejecting writes when full
+static inline void cb_set_overwrite(circular_buffer_t *cb, bool enable);
+static inline size_t cb_dropped_count(circular_buffer_t *cb);
+// Watermarks (low < high <= size): fn fires once when the fill level reaches high and once
+// when it falls back to low - not on every write - so producers can throttle in time.
+static inline bool cb_set_watermarks(circular_buffer_t *cb, size_t high, size_t low, cb_watermark_fn fn, void *ctx);
+static inline void cb_clear_watermarks(circular_buffer_t *cb);
 // To check whether buffer is empty
 static inline bool cb_is_empty(circular_buffer_t *cb);
 // To check whether buffer is full
@@ -37,6 +69,19 @@ static inline bool cb_read(circular_buffer_t *cb, uint8_t *data); // Returns suc
 static inline size_t cb_available_space(circular_buffer_t *cb);  // How much room is left?
 static inline size_t cb_data_count(circular_buffer_t *cb);  // How much data waiting?
 
+// Bulk functions - move a whole span with at most two memcpy calls instead of a loop of
+// cb_write/cb_read. Both return how many bytes were actually moved (may be less than len).
+static inline size_t cb_write_n(circular_buffer_t *cb, const uint8_t *data, size_t len);
+static inline size_t cb_read_n(circular_buffer_t *cb, uint8_t *data, size_t len);
+
+// Zero-copy functions - work on the buffer's storage in place (DMA, read(2), parsers).
+// Producer: reserve the free regions, fill them, then commit how many bytes were written.
+static inline size_t cb_write_reserve(circular_buffer_t *cb, cb_region_t regions[2]);
+static inline bool cb_write_commit(circular_buffer_t *cb, size_t len);
+// Consumer: peek at the waiting regions, then consume how many bytes were used.
+static inline size_t cb_read_peek(circular_buffer_t *cb, cb_region_t regions[2]);
+static inline bool cb_read_consume(circular_buffer_t *cb, size_t len);
+
 
 // Function Implementations:
 // Function sets up an initial empty buffer, connects struct to the caller's buffer,
@@ -47,34 +92,185 @@ static inline void cb_init(circular_buffer_t *cb, uint8_t *buffer, size_t size)
     cb->head = 0;
     cb->tail = 0;
     cb->count = 0;
+    cb->mask = 0;
+    cb->overwrite = false;
+    cb->dropped = 0;
+    cb->high_mark = SIZE_MAX;
+    cb->low_mark = 0;
+    cb->above_high = false;
+    cb->on_watermark = NULL;
+    cb->watermark_ctx = NULL;
+    cb->write_limit = size;
+    cb->read_limit = 0;
+}
+
+// In power-of-two mode head and tail are free-running counters: they are never wrapped,
+// the slot is (index & mask) instead of index % size, and head - tail is the count (it
+// stays correct through size_t overflow because size divides 2^64). count is unused.
+static inline bool cb_init_pow2(circular_buffer_t *cb, uint8_t *buffer, size_t size) {
+    if (size < 2 || (size & (size - 1)) != 0) {
+        return false;  // Not a power of two
+    }
+    cb_init(cb, buffer, size);
+    cb->mask = size - 1;
+    return true;
+}
+
+// Slot in the storage array for head/tail - only differs from the index in pow2 mode
+static inline size_t cb_slot(circular_buffer_t *cb, size_t index) {
+    return cb->mask ? (index & cb->mask) : index;
+}
+
+static inline void cb_set_overwrite(circular_buffer_t *cb, bool enable) {
+    cb->overwrite = enable;
+}
+
+static inline size_t cb_dropped_count(circular_buffer_t *cb) {
+    return cb->dropped;
+}
+
+// Fill levels at which cb_write/cb_read must leave their fast path. With no watermark
+// armed these are exactly the full (size) and empty (0) tests the fast paths need anyway,
+// so watermarks cost nothing per byte until one is set. Armed, the write limit is one
+// below the high mark (the byte written there reaches it) and the read limit one above
+// the low mark.
+static inline void cb_update_limits(circular_buffer_t *cb) {
+    bool armed = cb->on_watermark != NULL;
+    cb->write_limit = (armed && !cb->above_high) ? cb->high_mark - 1 : cb->size;
+    cb->read_limit = (armed && cb->above_high) ? cb->low_mark + 1 : 0;
+}
+
+// Out of line so the checks below stay a compare and a not-taken branch
+static inline __attribute__((noinline, cold)) void cb_fire_watermark(circular_buffer_t *cb, bool high) {
+    cb->above_high = high;
+    cb_update_limits(cb);
+    cb->on_watermark(cb->watermark_ctx, high ? CB_WATERMARK_HIGH : CB_WATERMARK_LOW);
+}
+
+// Moves tail past len waiting bytes (len <= cb_data_count)
+static inline void cb_drop_oldest(circular_buffer_t *cb, size_t len) {
+    if (cb->mask) {
+        cb->tail += len;
+        return;
+    }
+    cb->tail += len;
+    if (cb->tail >= cb->size) {
+        cb->tail -= cb->size;
+    }
+    cb->count -= len;
+}
+
+// Bulk calls: after data is added, with the new fill level - one compare while below the
+// high mark (always, when watermarks are off - high_mark is SIZE_MAX)
+static inline void cb_check_high(circular_buffer_t *cb, size_t count) {
+    if (__builtin_expect(count >= cb->high_mark, 0) && !cb->above_high) {
+        cb_fire_watermark(cb, true);
+    }
+}
+
+// Called after data is removed: one flag test unless a high crossing is outstanding
+static inline void cb_check_low(circular_buffer_t *cb, size_t count) {
+    if (__builtin_expect(cb->above_high, 0) && count <= cb->low_mark) {
+        cb_fire_watermark(cb, false);
+    }
+}
+
+static inline bool cb_set_watermarks(circular_buffer_t *cb, size_t high, size_t low, cb_watermark_fn fn, void *ctx) {
+    if (fn == NULL || low >= high || high > cb->size) {
+        return false;
+    }
+    cb->on_watermark = fn;
+    cb->watermark_ctx = ctx;
+    cb->low_mark = low;
+    cb->high_mark = high;
+    cb->above_high = false;
+    cb_update_limits(cb);
+    cb_check_high(cb, cb_data_count(cb));  // Already above: report it now, not on the next write
+    return true;
+}
+
+static inline void cb_clear_watermarks(circular_buffer_t *cb) {
+    cb->high_mark = SIZE_MAX;
+    cb->above_high = false;
+    cb->on_watermark = NULL;
+    cb_update_limits(cb);
 }
 
 static inline bool cb_is_empty(circular_buffer_t *cb) {
-    return cb->count == 0;
+    return cb_data_count(cb) == 0;
 }
 
 static inline bool cb_is_full(circular_buffer_t *cb) {
-    return cb->count == cb->size;
+    return cb_data_count(cb) == cb->size;
 }
 
-// Following FIFO Order - add from the head, read from the tail
-static inline bool cb_write(circular_buffer_t *cb, uint8_t data) {
-    // Tail points to the oldest data, head points to new data
+// Slow path of cb_write: the buffer is full, or this byte reaches the high watermark
+static inline __attribute__((noinline)) bool cb_write_slow(circular_buffer_t *cb, uint8_t data) {
     if (cb_is_full(cb)) {
-        return false;
+        if (!cb->overwrite) {
+            return false;
+        }
+        cb_drop_oldest(cb, 1);  // Overwrite mode: the oldest byte makes room
+        cb->dropped++;
+    }
+    cb->buffer[cb_slot(cb, cb->head)] = data;
+    if (cb->mask) {
+        cb->head++;
     } else {
-        cb->buffer[cb->head] = data;  // Store data at current head position
-        cb->head = (cb->head + 1) % cb->size;  // Move head to next position + wrap-around
+        cb->head = (cb->head + 1 == cb->size) ? 0 : cb->head + 1;
+        cb->count++;
+    }
+    cb_check_high(cb, cb_data_count(cb));
+    return true;
+}
+
+// Slow path of cb_read: the buffer is empty, or this byte brings it down to the low mark
+static inline __attribute__((noinline)) bool cb_read_slow(circular_buffer_t *cb, uint8_t *data) {
+    if (cb_is_empty(cb)) {
+        return false;
+    }
+    *data = cb->buffer[cb_slot(cb, cb->tail)];
+    cb_drop_oldest(cb, 1);
+    cb_check_low(cb, cb_data_count(cb));
+    return true;
+}
 
-        cb->count += 1;
+// Following FIFO Order - add from the head, read from the tail.
+// The full test doubles as the high watermark test (write_limit, see cb_update_limits).
+static inline bool cb_write(circular_buffer_t *cb, uint8_t data) {
+    if (cb->mask) {  // Power-of-two mode: mask instead of %, no count to maintain
+        if (cb->head - cb->tail >= cb->write_limit) {
+            return cb_write_slow(cb, data);
+        }
+        cb->buffer[cb->head & cb->mask] = data;
+        cb->head++;
         return true;
     }
+
+    // Tail points to the oldest data, head points to new data
+    if (cb->count >= cb->write_limit) {
+        return cb_write_slow(cb, data);  // Full (overwrite mode handled there) or high mark
+    }
+    cb->buffer[cb->head] = data;  // Store data at current head position
+    cb->head = (cb->head + 1) % cb->size;  // Move head to next position + wrap-around
+
+    cb->count += 1;
+    return true;
 }
 
-// Read from the tail
+// Read from the tail - the empty test doubles as the low watermark test (read_limit)
 static inline bool cb_read(circular_buffer_t *cb, uint8_t *data) {
-    if (cb_is_empty(cb)) {
-        return false;
+    if (cb->mask) {
+        if (cb->head - cb->tail <= cb->read_limit) {
+            return cb_read_slow(cb, data);
+        }
+        *data = cb->buffer[cb->tail & cb->mask];
+        cb->tail++;
+        return true;
+    }
+
+    if (cb->count <= cb->read_limit) {
+        return cb_read_slow(cb, data);
     } else {
         *data = cb->buffer[cb->tail];
         cb->tail = (cb->tail + 1) % cb->size;
@@ -85,11 +281,118 @@ static inline bool cb_read(circular_buffer_t *cb, uint8_t *data) {
 
 
 static inline size_t cb_available_space(circular_buffer_t *cb) {
-    return cb->size - cb->count;
+    return cb->size - cb_data_count(cb);
 }
 
 static inline size_t cb_data_count(circular_buffer_t *cb) {
-    return cb->count;
+    return cb->mask ? cb->head - cb->tail : cb->count;
+}
+
+// Zero-copy: describes free space starting at head, split at the end of the storage.
+static inline size_t cb_write_reserve(circular_buffer_t *cb, cb_region_t regions[2]) {
+    size_t space = cb_available_space(cb);
+    size_t head = cb_slot(cb, cb->head);
+    size_t first = cb->size - head;  // Room before the wrap point
+    if (first > space) {
+        first = space;
+    }
+    regions[0].data = cb->buffer + head;
+    regions[0].len = first;
+    regions[1].data = cb->buffer;  // Remainder (if any) starts back at the beginning
+    regions[1].len = space - first;
+    return space;
+}
+
+// Publishes len bytes the caller wrote into the reserved regions. Head is moved once,
+// with at most one wrap, so subtract instead of %.
+static inline bool cb_write_commit(circular_buffer_t *cb, size_t len) {
+    if (len > cb_available_space(cb)) {
+        return false;  // More than was ever reserved
+    }
+    if (cb->mask) {
+        cb->head += len;  // Free-running
+    } else {
+        cb->head += len;
+        if (cb->head >= cb->size) {
+            cb->head -= cb->size;
+        }
+        cb->count += len;
+    }
+    cb_check_high(cb, cb_data_count(cb));
+    return true;
+}
+
+// Zero-copy: describes waiting data starting at tail. Nothing is removed until
+// cb_read_consume, so a parser can look at a packet and leave it if it is incomplete.
+static inline size_t cb_read_peek(circular_buffer_t *cb, cb_region_t regions[2]) {
+    size_t count = cb_data_count(cb);
+    size_t tail = cb_slot(cb, cb->tail);
+    size_t first = cb->size - tail;
+    if (first > count) {
+        first = count;
+    }
+    regions[0].data = cb->buffer + tail;
+    regions[0].len = first;
+    regions[1].data = cb->buffer;
+    regions[1].len = count - first;
+    return count;
+}
+
+static inline bool cb_read_consume(circular_buffer_t *cb, size_t len) {
+    if (len > cb_data_count(cb)) {
+        return false;
+    }
+    cb_drop_oldest(cb, len);
+    cb_check_low(cb, cb_data_count(cb));
+    return true;
+}
+
+// Copies as much of data as fits: one memcpy per reserved region, one index update.
+// In overwrite mode everything is written: the oldest bytes are dropped to make room, and
+// if data is longer than the whole buffer only its last size bytes are kept.
+static inline size_t cb_write_n(circular_buffer_t *cb, const uint8_t *data, size_t len) {
+    size_t requested = len;
+    if (cb->overwrite) {
+        if (len > cb->size) {
+            cb->dropped += len - cb->size;
+            data += len - cb->size;
+            len = cb->size;
+        }
+        size_t space = cb_available_space(cb);
+        if (len > space) {
+            cb_drop_oldest(cb, len - space);  // Not a read: the level only dips to refill at once
+            cb->dropped += len - space;
+        }
+    }
+
+    cb_region_t regions[2];
+    size_t space = cb_write_reserve(cb, regions);
+    if (len > space) {
+        len = space;  // Partial write - caller checks the return value
+    }
+
+    size_t first = (len < regions[0].len) ? len : regions[0].len;
+    memcpy(regions[0].data, data, first);
+    memcpy(regions[1].data, data + first, len - first);  // No-op when nothing wrapped
+
+    cb_write_commit(cb, len);
+    return cb->overwrite ? requested : len;
+}
+
+// Mirror image of cb_write_n - reads from the tail in at most two segments.
+static inline size_t cb_read_n(circular_buffer_t *cb, uint8_t *data, size_t len) {
+    cb_region_t regions[2];
+    size_t count = cb_read_peek(cb, regions);
+    if (len > count) {
+        len = count;
+    }
+
+    size_t first = (len < regions[0].len) ? len : regions[0].len;
+    memcpy(data, regions[0].data, first);
+    memcpy(data + first, regions[1].data, len - first);
+
+    cb_read_consume(cb, len);
+    return len;
 }
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,339 @@
+// Compressed Ring - int32_t telemetry stored as compressed blocks inside a record ring.
+// Slowly changing counters and sensor readings differ very little from one sample to
+// the next, so storing every sample as a full 4-byte value wastes most of the buffer.
+// Values are collected into blocks of CR_BLOCK (128); a full block is encoded as
+// delta + zigzag (small signed changes become small unsigned numbers) and then bit-packed
+// with the width of its largest delta (frame-of-reference / BP128 layout, 4 lanes). A
+// signal that moves by a few units per sample packs to 2-4 bits per value, i.e. the same
+// memory holds 8-16x more history.
+// Encode/decode run 4 values per step with SSE2; other targets use a scalar version
+// that produces the same bytes.
+// When the ring is full the oldest block is dropped (retention of the newest history).
+// Reads return values oldest first: decoded blocks, then the block still being filled.
+// Not thread-safe on its own, like record_ring_t.
+#ifndef COMPRESSED_RING_H
+#define COMPRESSED_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "record_ring.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+#define CR_BLOCK 128                           // Values per encoded block
+#define CR_BLOCK_HEADER 8                      // int32_t first value, uint8_t bit width, padding
+#define CR_MAX_ENCODED (CR_BLOCK_HEADER + CR_BLOCK * 4)  // Block of 32-bit deltas
+
+typedef struct {
+    record_ring_t blocks;        // Encoded blocks in caller memory, oldest first
+    int32_t staging[CR_BLOCK];   // Newest values, encoded once CR_BLOCK have arrived
+    size_t stage_start;          // Values before this one were already read
+    size_t stage_end;
+    int32_t decoded[CR_BLOCK];   // Oldest block, taken out of the ring for reading
+    size_t decoded_pos;
+    size_t decoded_len;
+    size_t values;               // Values waiting to be read
+    size_t dropped;              // Values lost to retention (oldest blocks dropped)
+    size_t encoded_blocks;       // Blocks in the ring
+    size_t encoded_bytes;        // Ring bytes they take (record headers included)
+} compressed_ring_t;
+
+// Function Declarations:
+// memory (4-byte aligned) must hold at least one worst-case block, returns false otherwise
+static inline bool cr_init(compressed_ring_t *cr, uint8_t *memory, size_t size);
+static inline void cr_push(compressed_ring_t *cr, int32_t value);
+static inline void cr_push_n(compressed_ring_t *cr, const int32_t *values, size_t len);
+static inline bool cr_pop(compressed_ring_t *cr, int32_t *value);
+static inline size_t cr_pop_n(compressed_ring_t *cr, int32_t *values, size_t len);
+
+static inline size_t cr_size(compressed_ring_t *cr);
+static inline size_t cr_dropped_count(compressed_ring_t *cr);
+// Raw bytes of the encoded blocks / ring bytes they take (1.0 before the first block)
+static inline double cr_compression_ratio(compressed_ring_t *cr);
+
+// Block codec - out needs CR_MAX_ENCODED bytes; returns the encoded size
+static inline size_t cr_encode_block(const int32_t *in, uint8_t *out);
+static inline void cr_decode_block(const uint8_t *in, int32_t *out);
+
+// Helper Functions:
+// Zigzagged deltas of one block (the first delta is 0 - the first value is in the header).
+// Returns the OR of all of them, which gives the bit width.
+static inline uint32_t cr_delta_zigzag(const int32_t *in, uint32_t *out) {
+    size_t i = 0;
+    uint32_t bits_used = 0;
+#if defined(__SSE2__)
+    __m128i prev = _mm_set1_epi32(in[0]);
+    __m128i acc = _mm_setzero_si128();
+    for (; i < CR_BLOCK; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i before = _mm_or_si128(_mm_slli_si128(v, 4), _mm_srli_si128(prev, 12));  // in[i-1..i+2]
+        __m128i d = _mm_sub_epi32(v, before);
+        __m128i z = _mm_xor_si128(_mm_slli_epi32(d, 1), _mm_srai_epi32(d, 31));
+        _mm_storeu_si128((__m128i *)(out + i), z);
+        acc = _mm_or_si128(acc, z);
+        prev = v;
+    }
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_or_si128(acc, _mm_srli_si128(acc, 4));
+    bits_used = (uint32_t)_mm_cvtsi128_si32(acc);
+#else
+    uint32_t prev = (uint32_t)in[0];
+    for (; i < CR_BLOCK; i++) {
+        uint32_t d = (uint32_t)in[i] - prev;  // Unsigned: wraps instead of overflowing
+        uint32_t z = (d << 1) ^ (uint32_t)((int32_t)d >> 31);
+        out[i] = z;
+        bits_used |= z;
+        prev = (uint32_t)in[i];
+    }
+#endif
+    return bits_used;
+}
+
+// Packs CR_BLOCK values of bits bits each into 4 interleaved lanes of 32-bit words:
+// value i goes to lane i % 4, so 4 consecutive values are packed/unpacked in one step.
+static inline void cr_pack(const uint32_t *in, unsigned bits, uint8_t *out) {
+#if defined(__SSE2__)
+    __m128i word = _mm_setzero_si128();
+    unsigned shift = 0;
+    for (size_t i = 0; i < CR_BLOCK; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        word = _mm_or_si128(word, _mm_sll_epi32(v, _mm_cvtsi32_si128((int)shift)));
+        shift += bits;
+        if (shift >= 32) {
+            _mm_storeu_si128((__m128i *)out, word);
+            out += 16;
+            shift -= 32;
+            // Bits of v that did not fit start the next word
+            word = shift ? _mm_srl_epi32(v, _mm_cvtsi32_si128((int)(bits - shift))) : _mm_setzero_si128();
+        }
+    }
+#else
+    for (size_t lane = 0; lane < 4; lane++) {
+        uint32_t word = 0;
+        unsigned shift = 0;
+        uint8_t *dst = out + lane * 4;
+        for (size_t i = lane; i < CR_BLOCK; i += 4) {
+            word |= in[i] << shift;
+            shift += bits;
+            if (shift >= 32) {
+                memcpy(dst, &word, 4);
+                dst += 16;
+                shift -= 32;
+                word = shift ? in[i] >> (bits - shift) : 0;
+            }
+        }
+    }
+#endif
+}
+
+static inline void cr_unpack(const uint8_t *in, unsigned bits, uint32_t *out) {
+    if (bits == 0) {
+        memset(out, 0, CR_BLOCK * sizeof(uint32_t));
+        return;
+    }
+    uint32_t mask = (bits == 32) ? 0xFFFFFFFFu : (1u << bits) - 1;
+#if defined(__SSE2__)
+    __m128i lanes_mask = _mm_set1_epi32((int)mask);
+    __m128i word = _mm_loadu_si128((const __m128i *)in);
+    unsigned w = 0;
+    unsigned shift = 0;
+    for (size_t i = 0; i < CR_BLOCK; i += 4) {
+        __m128i v = _mm_srl_epi32(word, _mm_cvtsi32_si128((int)shift));
+        unsigned used = shift + bits;
+        if (used > 32) {
+            // Value straddles two words: high part comes from the next one
+            word = _mm_loadu_si128((const __m128i *)(in + 16 * ++w));
+            v = _mm_or_si128(v, _mm_sll_epi32(word, _mm_cvtsi32_si128((int)(32 - shift))));
+            shift = used - 32;
+        } else if (used == 32) {
+            if (++w < bits) {
+                word = _mm_loadu_si128((const __m128i *)(in + 16 * w));
+            }
+            shift = 0;
+        } else {
+            shift = used;
+        }
+        _mm_storeu_si128((__m128i *)(out + i), _mm_and_si128(v, lanes_mask));
+    }
+#else
+    for (size_t lane = 0; lane < 4; lane++) {
+        const uint8_t *src = in + lane * 4;
+        uint32_t word;
+        memcpy(&word, src, 4);
+        unsigned w = 0;
+        unsigned shift = 0;
+        for (size_t i = lane; i < CR_BLOCK; i += 4) {
+            uint32_t v = word >> shift;
+            unsigned used = shift + bits;
+            if (used > 32) {
+                memcpy(&word, src + 16 * ++w, 4);
+                v |= word << (32 - shift);
+                shift = used - 32;
+            } else if (used == 32) {
+                if (++w < bits) {
+                    memcpy(&word, src + 16 * w, 4);
+                }
+                shift = 0;
+            } else {
+                shift = used;
+            }
+            out[i] = v & mask;
+        }
+    }
+#endif
+}
+
+// Undoes zigzag and delta: out[i] = first + sum of the deltas up to i
+static inline void cr_undelta(const uint32_t *in, int32_t first, int32_t *out) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i running = _mm_set1_epi32(first);
+    __m128i one = _mm_set1_epi32(1);
+    for (; i < CR_BLOCK; i += 4) {
+        __m128i z = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i d = _mm_xor_si128(_mm_srli_epi32(z, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(z, one)));
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 4));  // Prefix sum across the 4 lanes
+        d = _mm_add_epi32(d, _mm_slli_si128(d, 8));
+        __m128i v = _mm_add_epi32(d, running);
+        _mm_storeu_si128((__m128i *)(out + i), v);
+        running = _mm_shuffle_epi32(v, 0xFF);  // Last value, broadcast
+    }
+#else
+    uint32_t value = (uint32_t)first;
+    for (; i < CR_BLOCK; i++) {
+        value += (in[i] >> 1) ^ (0u - (in[i] & 1));
+        out[i] = (int32_t)value;
+    }
+#endif
+}
+
+// Encodes the full staging block into the ring, dropping the oldest blocks to make room
+static inline void cr_flush_block(compressed_ring_t *cr) {
+    uint8_t encoded[CR_MAX_ENCODED];
+    size_t len = cr_encode_block(cr->staging, encoded);
+    uint8_t *slot;
+    while ((slot = rr_reserve(&cr->blocks, len)) == NULL) {
+        size_t old_len = 0;  // Never empty here: cr_init made room for a worst-case block
+        rr_peek(&cr->blocks, &old_len);
+        rr_consume(&cr->blocks);
+        cr->encoded_blocks--;
+        cr->encoded_bytes -= rr_record_size(old_len);
+        cr->values -= CR_BLOCK;
+        cr->dropped += CR_BLOCK;
+    }
+    memcpy(slot, encoded, len);
+    rr_commit(&cr->blocks, len);
+    cr->encoded_blocks++;
+    cr->encoded_bytes += rr_record_size(len);
+    cr->stage_end = 0;
+}
+
+// Function Implementations:
+static inline size_t cr_encode_block(const int32_t *in, uint8_t *out) {
+    uint32_t zigzag[CR_BLOCK];
+    uint32_t bits_used = cr_delta_zigzag(in, zigzag);
+    unsigned bits = bits_used ? 32 - (unsigned)__builtin_clz(bits_used) : 0;
+    memcpy(out, &in[0], 4);
+    out[4] = (uint8_t)bits;
+    out[5] = out[6] = out[7] = 0;
+    cr_pack(zigzag, bits, out + CR_BLOCK_HEADER);
+    return CR_BLOCK_HEADER + (size_t)bits * 16;  // 128 values * bits / 8
+}
+
+static inline void cr_decode_block(const uint8_t *in, int32_t *out) {
+    int32_t first;
+    memcpy(&first, in, 4);
+    uint32_t zigzag[CR_BLOCK];
+    cr_unpack(in + CR_BLOCK_HEADER, in[4], zigzag);
+    cr_undelta(zigzag, first, out);
+}
+
+static inline bool cr_init(compressed_ring_t *cr, uint8_t *memory, size_t size) {
+    if ((size & ~(size_t)3) < rr_record_size(CR_MAX_ENCODED)) {
+        return false;  // A block of incompressible values would never fit
+    }
+    rr_init(&cr->blocks, memory, size);
+    cr->stage_start = cr->stage_end = 0;
+    cr->decoded_pos = cr->decoded_len = 0;
+    cr->values = 0;
+    cr->dropped = 0;
+    cr->encoded_blocks = 0;
+    cr->encoded_bytes = 0;
+    return true;
+}
+
+static inline void cr_push(compressed_ring_t *cr, int32_t value) {
+    cr->staging[cr->stage_end++] = value;
+    cr->values++;
+    if (cr->stage_end == CR_BLOCK) {
+        if (cr->stage_start == 0) {
+            cr_flush_block(cr);
+        } else {
+            // The reader already took the front of this block: keep collecting
+            memmove(cr->staging, cr->staging + cr->stage_start, (CR_BLOCK - cr->stage_start) * sizeof(int32_t));
+            cr->stage_end -= cr->stage_start;
+            cr->stage_start = 0;
+        }
+    }
+}
+
+static inline void cr_push_n(compressed_ring_t *cr, const int32_t *values, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        cr_push(cr, values[i]);
+    }
+}
+
+static inline bool cr_pop(compressed_ring_t *cr, int32_t *value) {
+    if (cr->decoded_pos == cr->decoded_len && !rr_is_empty(&cr->blocks)) {
+        // Take the oldest block out of the ring so retention can not drop it mid-read
+        size_t len;
+        const uint8_t *block = rr_peek(&cr->blocks, &len);
+        cr_decode_block(block, cr->decoded);
+        rr_consume(&cr->blocks);
+        cr->encoded_blocks--;
+        cr->encoded_bytes -= rr_record_size(len);
+        cr->decoded_pos = 0;
+        cr->decoded_len = CR_BLOCK;
+    }
+    if (cr->decoded_pos < cr->decoded_len) {
+        *value = cr->decoded[cr->decoded_pos++];
+    } else if (cr->stage_start < cr->stage_end) {
+        *value = cr->staging[cr->stage_start++];
+        if (cr->stage_start == cr->stage_end) {
+            cr->stage_start = cr->stage_end = 0;
+        }
+    } else {
+        return false;
+    }
+    cr->values--;
+    return true;
+}
+
+static inline size_t cr_pop_n(compressed_ring_t *cr, int32_t *values, size_t len) {
+    size_t n = 0;
+    while (n < len && cr_pop(cr, &values[n])) {
+        n++;
+    }
+    return n;
+}
+
+static inline size_t cr_size(compressed_ring_t *cr) {
+    return cr->values;
+}
+
+static inline size_t cr_dropped_count(compressed_ring_t *cr) {
+    return cr->dropped;
+}
+
+static inline double cr_compression_ratio(compressed_ring_t *cr) {
+    if (cr->encoded_blocks == 0) {
+        return 1.0;
+    }
+    return (double)(cr->encoded_blocks * CR_BLOCK * sizeof(int32_t)) / (double)cr->encoded_bytes;
+}
+
+#endif
@@ -4,6 +4,24 @@
 #define EMBEDDED_DS_H
 
 #include "circular_buffer.h"
+#include "cb_scan.h"
+#include "cb_io.h"
+#include "cb_uring.h"
+#include "spsc_buffer.h"
+#include "mirrored_buffer.h"
+#include "ring.h"
+#include "window_ring.h"
+#include "ring_channel.h"
+#include "mpmc_queue.h"
+#include "ws_deque.h"
+#include "shm_ring.h"
+#include "record_ring.h"
+#include "lane_ring.h"
+#include "compressed_ring.h"
+#include "timeseries_ring.h"
+#include "broadcast_ring.h"
+#include "latest_value.h"
+#include "ring_log.h"
 #include "memory_pool.h"
 #include "fixed_hash_table.h"
 #include "stack_allocator.h"
@@ -0,0 +1,146 @@
+// Lane Ring = K record rings (lanes) carved out of one caller-provided block, drained by
+// priority. With a single circular_buffer_t a control message waits behind every byte of
+// bulk data queued before it; with lanes it only waits behind its own lane.
+// Dequeue policies:
+// - LR_STRICT: always the lowest-numbered non-empty lane (lane 0 = highest priority).
+// - LR_WEIGHTED: round-robin over the non-empty lanes, each lane served up to its weight
+//   in messages before moving on, so a flooded lane cannot starve the others.
+// A bitmap with one bit per non-empty lane makes picking the next lane O(1) (count
+// trailing zeros) however many lanes there are. Messages are variable-length and
+// handed out in place, exactly like record_ring_t.
+// Not thread-safe on its own, like record_ring_t.
+#ifndef LANE_RING_H
+#define LANE_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "record_ring.h"
+using namespace std;
+
+#define LR_MAX_LANES 32  // One bit per lane in the non-empty bitmap
+
+typedef enum {
+    LR_STRICT,    // Lowest-numbered non-empty lane first
+    LR_WEIGHTED   // Weighted round-robin over the non-empty lanes
+} lr_policy_t;
+
+typedef struct {
+    record_ring_t lanes[LR_MAX_LANES];
+    uint32_t weights[LR_MAX_LANES];  // Messages per turn in LR_WEIGHTED (>= 1)
+    size_t num_lanes;
+    uint32_t nonempty;   // Bit i set while lane i holds messages
+    lr_policy_t policy;
+    size_t current;      // Lane whose turn it is (LR_WEIGHTED)
+    uint32_t credit;     // Messages the current lane may still send this turn
+} lane_ring_t;
+
+// Function Declarations:
+// Splits memory (4-byte aligned) into num_lanes lanes of lane_sizes[i] bytes each, or into
+// equal lanes when lane_sizes is NULL. False if the lanes do not fit or num_lanes is bad.
+static inline bool lr_init(lane_ring_t *lr, uint8_t *memory, size_t size, const size_t *lane_sizes, size_t num_lanes);
+static inline void lr_set_policy(lane_ring_t *lr, lr_policy_t policy);
+static inline bool lr_set_weight(lane_ring_t *lr, size_t lane, uint32_t weight);
+
+// Producer: appends a message to one lane (false when that lane is full)
+static inline bool lr_push(lane_ring_t *lr, size_t lane, const void *data, size_t len);
+// Consumer: next message by the current policy, in place (NULL when every lane is empty),
+// then consume it from the lane it came from
+static inline const uint8_t* lr_peek(lane_ring_t *lr, size_t *lane, size_t *len);
+static inline bool lr_consume(lane_ring_t *lr, size_t lane);
+
+static inline bool lr_is_empty(lane_ring_t *lr);
+static inline size_t lr_lane_count(lane_ring_t *lr, size_t lane);
+
+// Helper Functions:
+// Lane the next message comes from - only called while some lane is non-empty
+static inline size_t lr_select(lane_ring_t *lr) {
+    if (lr->policy == LR_STRICT) {
+        return (size_t)__builtin_ctz(lr->nonempty);
+    }
+    if (lr->credit > 0 && (lr->nonempty >> lr->current) & 1) {
+        return lr->current;  // Current lane still has messages and credit
+    }
+    // Next non-empty lane after the current one, wrapping around to the lowest
+    uint32_t later = lr->nonempty & ~(uint32_t)((2ull << lr->current) - 1);
+    lr->current = (size_t)__builtin_ctz(later != 0 ? later : lr->nonempty);
+    lr->credit = lr->weights[lr->current];
+    return lr->current;
+}
+
+// Function Implementations:
+static inline bool lr_init(lane_ring_t *lr, uint8_t *memory, size_t size, const size_t *lane_sizes, size_t num_lanes) {
+    if (num_lanes == 0 || num_lanes > LR_MAX_LANES) {
+        return false;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < num_lanes; i++) {
+        size_t lane_size = (lane_sizes != NULL) ? lane_sizes[i] : size / num_lanes;
+        lane_size &= ~(size_t)3;  // Keeps every lane 4-byte aligned
+        if (lane_size > size - offset) {
+            return false;
+        }
+        rr_init(&lr->lanes[i], memory + offset, lane_size);
+        lr->weights[i] = 1;
+        offset += lane_size;
+    }
+    lr->num_lanes = num_lanes;
+    lr->nonempty = 0;
+    lr->policy = LR_STRICT;
+    lr->current = num_lanes - 1;  // The first weighted turn wraps around to lane 0
+    lr->credit = 0;
+    return true;
+}
+
+static inline void lr_set_policy(lane_ring_t *lr, lr_policy_t policy) {
+    lr->policy = policy;
+    lr->current = lr->num_lanes - 1;  // Start a fresh round at lane 0
+    lr->credit = 0;
+}
+
+static inline bool lr_set_weight(lane_ring_t *lr, size_t lane, uint32_t weight) {
+    if (lane >= lr->num_lanes || weight == 0) {
+        return false;
+    }
+    lr->weights[lane] = weight;
+    return true;
+}
+
+static inline bool lr_push(lane_ring_t *lr, size_t lane, const void *data, size_t len) {
+    if (lane >= lr->num_lanes || !rr_append(&lr->lanes[lane], data, len)) {
+        return false;
+    }
+    lr->nonempty |= (uint32_t)1 << lane;
+    return true;
+}
+
+static inline const uint8_t* lr_peek(lane_ring_t *lr, size_t *lane, size_t *len) {
+    if (lr->nonempty == 0) {
+        return NULL;
+    }
+    *lane = lr_select(lr);
+    return rr_peek(&lr->lanes[*lane], len);
+}
+
+static inline bool lr_consume(lane_ring_t *lr, size_t lane) {
+    if (lane >= lr->num_lanes || !rr_consume(&lr->lanes[lane])) {
+        return false;
+    }
+    if (rr_is_empty(&lr->lanes[lane])) {
+        lr->nonempty &= ~((uint32_t)1 << lane);
+    }
+    if (lr->policy == LR_WEIGHTED && lane == lr->current && lr->credit > 0) {
+        lr->credit--;
+    }
+    return true;
+}
+
+static inline bool lr_is_empty(lane_ring_t *lr) {
+    return lr->nonempty == 0;
+}
+
+static inline size_t lr_lane_count(lane_ring_t *lr, size_t lane) {
+    return rr_record_count(&lr->lanes[lane]);
+}
+
+#endif
@@ -0,0 +1,152 @@
+// Latest-value slots - "give me the newest reading" without queueing stale ones.
+// A ring makes the reader copy every old entry before it reaches the newest; here the
+// writer simply replaces the value and readers always get the most recent one.
+// Two flavours, both single writer and both with caller-provided storage:
+// - lv_slot_t (seqlock): one copy of the value plus a sequence counter. The writer never
+//   waits; any number of readers copy the value out and retry if a write overlapped.
+//   Best for small values (a few cache lines) and many readers.
+// - triple_buffer_t: three copies of the value and one reader. Writer and reader each own
+//   a copy and swap it through a shared index, so both work in place with no retries and
+//   no copying - better for large values.
+#ifndef LATEST_VALUE_H
+#define LATEST_VALUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+using namespace std;
+
+#ifndef LV_CACHE_LINE_SIZE
+#define LV_CACHE_LINE_SIZE 64
+#endif
+
+// Storage a seqlock slot needs for a value of value_size bytes (whole 8-byte words)
+#define LV_STORAGE_SIZE(value_size) (((value_size) + 7) & ~(size_t)7)
+
+typedef struct {
+    alignas(LV_CACHE_LINE_SIZE) uint64_t sequence;  // Odd while a write is in progress, 0 = never written
+    uint64_t *data;      // Caller storage, LV_STORAGE_SIZE(value_size) bytes, 8-byte aligned
+    size_t value_size;   // Size of the value (bytes)
+} lv_slot_t;
+
+#define TB_FRESH 4u  // Set in middle when it holds a value the reader has not taken yet
+
+typedef struct {
+    uint8_t *memory;     // Caller storage: 3 * value_size bytes
+    size_t value_size;
+    alignas(LV_CACHE_LINE_SIZE) uint32_t middle;  // Copy being handed over (index | TB_FRESH)
+    alignas(LV_CACHE_LINE_SIZE) uint32_t back;    // Writer's copy
+    alignas(LV_CACHE_LINE_SIZE) uint32_t front;   // Reader's copy
+    bool has_value;      // Reader has taken at least one value
+} triple_buffer_t;
+
+// Function Declarations:
+static inline void lv_init(lv_slot_t *slot, uint64_t *storage, size_t value_size);
+// Writer: replaces the value - wait-free
+static inline void lv_publish(lv_slot_t *slot, const void *value);
+// Readers: copies a consistent snapshot into out. False if nothing was published yet.
+static inline bool lv_read(lv_slot_t *slot, void *out);
+// Number of values published so far - lets a reader skip a copy it already has
+static inline uint64_t lv_version(lv_slot_t *slot);
+
+static inline void tb_init(triple_buffer_t *tb, uint8_t *memory, size_t value_size);
+// Writer: fill the copy it owns in place, then publish it as the newest value
+static inline void *tb_write_buffer(triple_buffer_t *tb);
+static inline void tb_publish(triple_buffer_t *tb);
+// Reader: newest value in place (valid until the next call), NULL before the first
+// publish. fresh (optional) tells whether it changed since the previous call.
+static inline const void *tb_read_latest(triple_buffer_t *tb, bool *fresh);
+
+// Helper Functions:
+// The value is copied as relaxed atomic words: a reader may overlap a write, and the
+// sequence check afterwards decides whether the copy is kept
+static inline void lv_copy_in(uint64_t *dst, const uint8_t *src, size_t size) {
+    size_t words = LV_STORAGE_SIZE(size) / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word = 0;
+        size_t n = (size - i * 8 < 8) ? size - i * 8 : 8;
+        memcpy(&word, src + i * 8, n);
+        __atomic_store_n(&dst[i], word, __ATOMIC_RELAXED);
+    }
+}
+
+static inline void lv_copy_out(uint8_t *dst, const uint64_t *src, size_t size) {
+    size_t words = LV_STORAGE_SIZE(size) / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+        size_t n = (size - i * 8 < 8) ? size - i * 8 : 8;
+        memcpy(dst + i * 8, &word, n);
+    }
+}
+
+// Function Implementations:
+static inline void lv_init(lv_slot_t *slot, uint64_t *storage, size_t value_size) {
+    slot->sequence = 0;
+    slot->data = storage;
+    slot->value_size = value_size;
+}
+
+static inline void lv_publish(lv_slot_t *slot, const void *value) {
+    uint64_t sequence = slot->sequence;  // Only the writer stores it
+    __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);  // Odd: write in progress
+    __atomic_thread_fence(__ATOMIC_RELEASE);  // Readers that see new data also see the odd sequence
+    lv_copy_in(slot->data, (const uint8_t *)value, slot->value_size);
+    __atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+static inline bool lv_read(lv_slot_t *slot, void *out) {
+    for (;;) {
+        uint64_t before = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (before == 0) {
+            return false;  // Never published
+        }
+        if (before & 1) {
+            continue;  // Writer is in the middle of a copy
+        }
+        lv_copy_out((uint8_t *)out, slot->data, slot->value_size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);  // The copy is done before the recheck
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == before) {
+            return true;
+        }
+    }
+}
+
+static inline uint64_t lv_version(lv_slot_t *slot) {
+    return __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) / 2;
+}
+
+static inline void tb_init(triple_buffer_t *tb, uint8_t *memory, size_t value_size) {
+    tb->memory = memory;
+    tb->value_size = value_size;
+    tb->back = 0;
+    tb->middle = 1;
+    tb->front = 2;
+    tb->has_value = false;
+}
+
+static inline void *tb_write_buffer(triple_buffer_t *tb) {
+    return tb->memory + tb->back * tb->value_size;
+}
+
+// Acq_rel exchange: our copy is handed over complete, and the copy we get back was
+// released by the reader before it swapped it in.
+static inline void tb_publish(triple_buffer_t *tb) {
+    uint32_t previous = __atomic_exchange_n(&tb->middle, tb->back | TB_FRESH, __ATOMIC_ACQ_REL);
+    tb->back = previous & 3;
+}
+
+static inline const void *tb_read_latest(triple_buffer_t *tb, bool *fresh) {
+    bool changed = (__atomic_load_n(&tb->middle, __ATOMIC_ACQUIRE) & TB_FRESH) != 0;
+    if (changed) {
+        uint32_t previous = __atomic_exchange_n(&tb->middle, tb->front, __ATOMIC_ACQ_REL);
+        tb->front = previous & 3;
+        tb->has_value = true;
+    }
+    if (fresh != NULL) {
+        *fresh = changed;
+    }
+    return tb->has_value ? tb->memory + tb->front * tb->value_size : NULL;
+}
+
+#endif
@@ -0,0 +1,110 @@
+// Mirrored (double-mapped) circular buffer - Linux only.
+// The same memfd pages are mapped twice, back to back, so storage[i] and
+// storage[i + size] are the same byte. Any free or waiting region of the ring is then
+// one contiguous span, even across the wrap point, and can be handed as a single
+// pointer to writev, a decompressor or a parser with no copying.
+// Exception to the caller-provided memory rule: a double mapping cannot be built on
+// top of an arbitrary caller array, so the pages come from the kernel in mb_init and
+// are given back in mb_destroy. Meant for large (MB-sized) streaming buffers on a
+// Linux host, not for the small MCU-side buffers.
+#ifndef MIRRORED_BUFFER_H
+#define MIRRORED_BUFFER_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "circular_buffer.h"
+using namespace std;
+
+typedef struct {
+    circular_buffer_t cb;  // Indices + storage - cb.buffer points at the double mapping
+    int fd;                // memfd behind both views, -1 when not initialised
+} mirrored_buffer_t;
+
+// Function Declarations:
+// size must be a multiple of the page size; power-of-two sizes get cb_init_pow2
+static inline bool mb_init(mirrored_buffer_t *mb, size_t size);
+static inline void mb_destroy(mirrored_buffer_t *mb);
+// Zero-copy, always a single region. len receives its length (0 = full/empty).
+static inline uint8_t* mb_write_reserve(mirrored_buffer_t *mb, size_t *len);
+static inline bool mb_write_commit(mirrored_buffer_t *mb, size_t len);
+static inline uint8_t* mb_read_peek(mirrored_buffer_t *mb, size_t *len);
+static inline bool mb_read_consume(mirrored_buffer_t *mb, size_t len);
+
+// Function Implementations:
+// Reserves 2*size bytes of address space first, then maps the memfd over each half
+// with MAP_FIXED, so no other mapping can land between the two views.
+static inline bool mb_init(mirrored_buffer_t *mb, size_t size) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    mb->fd = -1;
+    if (size == 0 || page_size <= 0 || size % (size_t)page_size != 0) {
+        return false;
+    }
+
+    int fd = memfd_create("mirrored_buffer", MFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return false;
+    }
+
+    void *base = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    uint8_t *first = (uint8_t *)base;
+    void *lower = mmap(first, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void *upper = mmap(first + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    if (lower == MAP_FAILED || upper == MAP_FAILED) {
+        munmap(base, 2 * size);
+        close(fd);
+        return false;
+    }
+
+    if (!cb_init_pow2(&mb->cb, first, size)) {
+        cb_init(&mb->cb, first, size);
+    }
+    mb->fd = fd;
+    return true;
+}
+
+static inline void mb_destroy(mirrored_buffer_t *mb) {
+    if (mb->fd < 0) {
+        return;
+    }
+    munmap(mb->cb.buffer, 2 * mb->cb.size);
+    close(mb->fd);
+    mb->fd = -1;
+    mb->cb.buffer = NULL;
+}
+
+// The free space starts at head and may run past the end of the first view - the
+// second view makes that the start of the storage.
+static inline uint8_t* mb_write_reserve(mirrored_buffer_t *mb, size_t *len) {
+    *len = cb_available_space(&mb->cb);
+    return mb->cb.buffer + cb_slot(&mb->cb, mb->cb.head);
+}
+
+static inline bool mb_write_commit(mirrored_buffer_t *mb, size_t len) {
+    return cb_write_commit(&mb->cb, len);
+}
+
+static inline uint8_t* mb_read_peek(mirrored_buffer_t *mb, size_t *len) {
+    *len = cb_data_count(&mb->cb);
+    return mb->cb.buffer + cb_slot(&mb->cb, mb->cb.tail);
+}
+
+static inline bool mb_read_consume(mirrored_buffer_t *mb, size_t len) {
+    return cb_read_consume(&mb->cb, len);
+}
+
+#endif // __linux__
+
+#endif
@@ -0,0 +1,174 @@
+// Multi-Producer/Multi-Consumer (MPMC) bounded queue - lock-free.
+// Wrapping circular_buffer_t in a mutex serialises every thread on one lock. This queue
+// follows Dmitry Vyukov's bounded MPMC design instead: every slot carries a sequence
+// number that says whose turn it is, so a producer (or consumer) only has to win one
+// compare-and-swap on the shared position and then works on its own slot while other
+// threads work on theirs.
+//   slot sequence == pos          -> slot is free for the producer claiming position pos
+//   slot sequence == pos + 1      -> slot holds the element for the consumer at pos
+//   consumer sets pos + capacity  -> slot is free again one lap later
+// Elements are fixed-size byte blobs (like the hash table's values) stored in
+// caller-provided memory, laid out as capacity slots of [sequence | element].
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+using namespace std;
+
+#ifndef MPMC_CACHE_LINE_SIZE
+#define MPMC_CACHE_LINE_SIZE 64
+#endif
+
+typedef struct {
+    // Read-only after init
+    uint8_t *memory;      // Caller-provided slot array (aligned for size_t)
+    size_t capacity;      // Number of slots - power of two
+    size_t mask;          // capacity - 1
+    size_t element_size;  // Size of each element (bytes)
+    size_t slot_size;     // Sequence + element, rounded up to keep sequences aligned
+
+    // Producers and consumers contend on different lines
+    alignas(MPMC_CACHE_LINE_SIZE) size_t enqueue_pos;  // Next position to produce
+    alignas(MPMC_CACHE_LINE_SIZE) size_t dequeue_pos;  // Next position to consume
+} mpmc_queue_t;
+
+// Function Declarations:
+// Bytes of memory mpmc_init needs for a given capacity/element size
+static inline size_t mpmc_memory_size(size_t capacity, size_t element_size);
+// capacity must be a power of two (>= 2), returns false otherwise
+static inline bool mpmc_init(mpmc_queue_t *q, uint8_t *memory, size_t capacity, size_t element_size);
+static inline bool mpmc_enqueue(mpmc_queue_t *q, const void *element);
+static inline bool mpmc_dequeue(mpmc_queue_t *q, void *element);
+// Batch versions claim up to n consecutive slots with a single CAS. Return how many
+// elements were actually moved (a prefix of the array).
+static inline size_t mpmc_enqueue_n(mpmc_queue_t *q, const void *elements, size_t n);
+static inline size_t mpmc_dequeue_n(mpmc_queue_t *q, void *elements, size_t n);
+// Snapshot only - other threads may change it immediately
+static inline size_t mpmc_size_approx(mpmc_queue_t *q);
+
+// Helper Functions:
+static inline size_t mpmc_slot_size(size_t element_size) {
+    size_t raw = sizeof(size_t) + element_size;
+    return (raw + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+}
+
+static inline size_t *mpmc_sequence(mpmc_queue_t *q, size_t pos) {
+    return (size_t *)(q->memory + (pos & q->mask) * q->slot_size);
+}
+
+static inline uint8_t *mpmc_element(mpmc_queue_t *q, size_t pos) {
+    return q->memory + (pos & q->mask) * q->slot_size + sizeof(size_t);
+}
+
+// Signed distance between a slot's sequence and the position we are looking for
+static inline intptr_t mpmc_diff(size_t sequence, size_t expected) {
+    return (intptr_t)(sequence - expected);
+}
+
+// Function Implementations:
+static inline size_t mpmc_memory_size(size_t capacity, size_t element_size) {
+    return capacity * mpmc_slot_size(element_size);
+}
+
+// Must be called before any producer or consumer thread touches the queue.
+static inline bool mpmc_init(mpmc_queue_t *q, uint8_t *memory, size_t capacity, size_t element_size) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return false;  // Not a power of two
+    }
+    q->memory = memory;
+    q->capacity = capacity;
+    q->mask = capacity - 1;
+    q->element_size = element_size;
+    q->slot_size = mpmc_slot_size(element_size);
+    q->enqueue_pos = 0;
+    q->dequeue_pos = 0;
+
+    // Slot i is free for the producer of position i
+    for (size_t i = 0; i < capacity; i++) {
+        *mpmc_sequence(q, i) = i;
+    }
+    return true;
+}
+
+// Claims up to n consecutive positions starting at *pos whose slot sequences equal
+// pos + i + offset (offset 0 = free for producers, 1 = full for consumers).
+// Returns 0 when the queue is full (producers) / empty (consumers).
+static inline size_t mpmc_claim(mpmc_queue_t *q, size_t *shared_pos, size_t offset,
+                                size_t n, size_t *pos) {
+    *pos = __atomic_load_n(shared_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        size_t ready = 0;
+        intptr_t diff = 0;
+        while (ready < n) {
+            size_t sequence = __atomic_load_n(mpmc_sequence(q, *pos + ready), __ATOMIC_ACQUIRE);
+            diff = mpmc_diff(sequence, *pos + ready + offset);
+            if (diff != 0) {
+                break;
+            }
+            ready++;
+        }
+
+        if (ready == 0) {
+            if (diff < 0) {
+                return 0;  // Slot still belongs to the previous lap: full / empty
+            }
+            // Another thread already took this position - start over from the new one
+            *pos = __atomic_load_n(shared_pos, __ATOMIC_RELAXED);
+            continue;
+        }
+        // Only the owner of a position changes its slot, so every slot we counted is
+        // still ours if nobody moved the shared position in the meantime
+        if (__atomic_compare_exchange_n(shared_pos, pos, *pos + ready, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return ready;
+        }
+        // CAS failure reloaded *pos - retry
+    }
+}
+
+static inline bool mpmc_enqueue(mpmc_queue_t *q, const void *element) {
+    return mpmc_enqueue_n(q, element, 1) == 1;
+}
+
+static inline bool mpmc_dequeue(mpmc_queue_t *q, void *element) {
+    return mpmc_dequeue_n(q, element, 1) == 1;
+}
+
+// Each slot is published on its own (release on the sequence), so consumers can start
+// on the first elements of a batch while the rest are still being copied.
+static inline size_t mpmc_enqueue_n(mpmc_queue_t *q, const void *elements, size_t n) {
+    size_t pos;
+    size_t claimed = mpmc_claim(q, &q->enqueue_pos, 0, n, &pos);
+    const uint8_t *src = (const uint8_t *)elements;
+
+    for (size_t i = 0; i < claimed; i++) {
+        memcpy(mpmc_element(q, pos + i), src + i * q->element_size, q->element_size);
+        __atomic_store_n(mpmc_sequence(q, pos + i), pos + i + 1, __ATOMIC_RELEASE);
+    }
+    return claimed;
+}
+
+static inline size_t mpmc_dequeue_n(mpmc_queue_t *q, void *elements, size_t n) {
+    size_t pos;
+    size_t claimed = mpmc_claim(q, &q->dequeue_pos, 1, n, &pos);
+    uint8_t *dst = (uint8_t *)elements;
+
+    for (size_t i = 0; i < claimed; i++) {
+        memcpy(dst + i * q->element_size, mpmc_element(q, pos + i), q->element_size);
+        // Free for the producer one lap later
+        __atomic_store_n(mpmc_sequence(q, pos + i), pos + i + q->capacity, __ATOMIC_RELEASE);
+    }
+    return claimed;
+}
+
+static inline size_t mpmc_size_approx(mpmc_queue_t *q) {
+    size_t dequeue_pos = __atomic_load_n(&q->dequeue_pos, __ATOMIC_RELAXED);
+    size_t enqueue_pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+    size_t size = enqueue_pos - dequeue_pos;
+    return (size > q->capacity) ? q->capacity : size;
+}
+
+#endif
@@ -0,0 +1,175 @@
+// Record Ring = circular buffer of variable-length messages (bip-buffer style).
+// Every record is stored as a 4-byte length header followed by the payload, and a
+// record is never split across the wrap point: when it does not fit before the end of
+// the storage, a wrap marker is left there and the record starts again at offset 0.
+// A message is therefore always one contiguous span - appended with one memcpy (or
+// written in place through rr_reserve/rr_commit) and handed back to the consumer as a
+// pointer into the ring, with no per-byte framing or reassembly.
+// Like circular_buffer_t, a record ring is not thread-safe on its own.
+#ifndef RECORD_RING_H
+#define RECORD_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+using namespace std;
+
+#define RR_HEADER_SIZE 4              // uint32_t payload length in front of every record
+#define RR_WRAP_MARKER 0xFFFFFFFFu    // Header value meaning "rest of storage unused"
+
+typedef struct {
+    uint8_t *buffer;  // Caller-provided storage, 4-byte aligned
+    size_t size;      // Usable size - rounded down to a multiple of 4
+    size_t head;      // Write offset (always < size)
+    size_t tail;      // Read offset (always < size)
+    size_t used;      // Bytes taken by records, padding and skipped space at the end
+    size_t records;   // Number of committed records waiting
+    size_t reserved;  // Payload length of the open reservation
+    bool reserving;   // A reservation is open (rr_reserve called, rr_commit not yet)
+} record_ring_t;
+
+// Function Declarations:
+static inline void rr_init(record_ring_t *rr, uint8_t *buffer, size_t size);
+// Producer: one contiguous block of len bytes inside the ring, or NULL if there is no
+// such block right now. Fill it, then commit (a shorter length may be committed).
+static inline uint8_t* rr_reserve(record_ring_t *rr, size_t len);
+static inline bool rr_commit(record_ring_t *rr, size_t len);
+// Reserve + memcpy + commit of a whole message in O(1)
+static inline bool rr_append(record_ring_t *rr, const void *data, size_t len);
+// Consumer: oldest message in place (NULL when empty), then drop it once processed
+static inline const uint8_t* rr_peek(record_ring_t *rr, size_t *len);
+static inline bool rr_consume(record_ring_t *rr);
+
+static inline bool rr_is_empty(record_ring_t *rr);
+static inline size_t rr_record_count(record_ring_t *rr);
+
+// Helper Functions:
+// Bytes a record of len payload bytes takes, header and padding included
+static inline size_t rr_record_size(size_t len) {
+    return (RR_HEADER_SIZE + len + 3) & ~(size_t)3;
+}
+
+static inline uint32_t rr_header_at(record_ring_t *rr, size_t offset) {
+    uint32_t header;
+    memcpy(&header, rr->buffer + offset, sizeof(header));
+    return header;
+}
+
+// If the reader has arrived at the space a writer skipped at the end, jump to offset 0
+static inline void rr_skip_wrap(record_ring_t *rr) {
+    if (rr->records > 0 && rr_header_at(rr, rr->tail) == RR_WRAP_MARKER) {
+        rr->used -= rr->size - rr->tail;
+        rr->tail = 0;
+    }
+}
+
+// Function Implementations:
+static inline void rr_init(record_ring_t *rr, uint8_t *buffer, size_t size) {
+    rr->buffer = buffer;
+    rr->size = size & ~(size_t)3;
+    rr->head = 0;
+    rr->tail = 0;
+    rr->used = 0;
+    rr->records = 0;
+    rr->reserved = 0;
+    rr->reserving = false;
+}
+
+static inline uint8_t* rr_reserve(record_ring_t *rr, size_t len) {
+    size_t need = rr_record_size(len);
+    if (len >= RR_WRAP_MARKER || need > rr->size) {
+        return NULL;  // Can never fit
+    }
+    if (rr->used == 0) {
+        rr->head = rr->tail = 0;  // Empty: restart at 0 for the largest contiguous block
+    }
+
+    if (rr->head > rr->tail || rr->used == 0) {
+        // Free space is [head, size) and [0, tail)
+        if (need > rr->size - rr->head) {
+            if (need > rr->tail) {
+                return NULL;  // Neither piece is big enough
+            }
+            // Leave the end unused so the record stays contiguous
+            uint32_t marker = RR_WRAP_MARKER;
+            memcpy(rr->buffer + rr->head, &marker, sizeof(marker));
+            rr->used += rr->size - rr->head;
+            rr->head = 0;
+        }
+    } else if (rr->head == rr->tail || need > rr->tail - rr->head) {
+        return NULL;  // Full, or the single free piece [head, tail) is too small
+    }
+
+    rr->reserved = len;
+    rr->reserving = true;
+    return rr->buffer + rr->head + RR_HEADER_SIZE;
+}
+
+// The header is written at commit time, so a consumer never sees a half-filled record.
+static inline bool rr_commit(record_ring_t *rr, size_t len) {
+    if (!rr->reserving || len > rr->reserved) {
+        return false;  // Nothing (that large) was reserved
+    }
+    uint32_t header = (uint32_t)len;
+    memcpy(rr->buffer + rr->head, &header, sizeof(header));
+
+    size_t record_size = rr_record_size(len);
+    rr->head += record_size;
+    if (rr->head == rr->size) {
+        rr->head = 0;
+    }
+    rr->used += record_size;
+    rr->records++;
+    rr->reserving = false;
+    return true;
+}
+
+static inline bool rr_append(record_ring_t *rr, const void *data, size_t len) {
+    uint8_t *payload = rr_reserve(rr, len);
+    if (payload == NULL) {
+        return false;
+    }
+    memcpy(payload, data, len);
+    return rr_commit(rr, len);
+}
+
+static inline const uint8_t* rr_peek(record_ring_t *rr, size_t *len) {
+    if (rr->records == 0) {
+        return NULL;
+    }
+    rr_skip_wrap(rr);
+    *len = rr_header_at(rr, rr->tail);
+    return rr->buffer + rr->tail + RR_HEADER_SIZE;
+}
+
+static inline bool rr_consume(record_ring_t *rr) {
+    if (rr->records == 0) {
+        return false;
+    }
+    rr_skip_wrap(rr);
+    size_t record_size = rr_record_size(rr_header_at(rr, rr->tail));
+    rr->tail += record_size;
+    if (rr->tail == rr->size) {
+        rr->tail = 0;
+    }
+    rr->used -= record_size;
+    rr->records--;
+    if (rr->records == 0) {
+        // Only skipped space at the end can be left: release it too, so the next
+        // reservation gets the whole ring instead of just [head, tail)
+        rr->tail = rr->head;
+        rr->used = 0;
+    }
+    return true;
+}
+
+static inline bool rr_is_empty(record_ring_t *rr) {
+    return rr->records == 0;
+}
+
+static inline size_t rr_record_count(record_ring_t *rr) {
+    return rr->records;
+}
+
+#endif
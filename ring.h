@@ -0,0 +1,170 @@
+// Typed ring buffer - same head/tail/count design as circular_buffer_t, but for any
+// element type T and with the capacity N fixed at compile time.
+// Storage is raw, properly aligned memory inside the object (no heap): elements are
+// constructed in place by push/emplace and destroyed by pop/clear, so T does not need
+// a default constructor. Trivially copyable types (plain structs, ints, floats) take a
+// memcpy fast path in write_n/read_n - at most two memcpy calls per span, like
+// cb_write_n/cb_read_n.
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+template <typename T, size_t N>
+class ring {
+    static_assert(N > 0, "ring capacity must be at least 1");
+
+public:
+    ring() : head(0), tail(0), count(0) {}
+    ~ring() { clear(); }
+
+    // Elements live inside the object - copying the ring would mean copying them all
+    ring(const ring &) = delete;
+    ring &operator=(const ring &) = delete;
+
+    // Constructs the element directly in its slot. Returns false when full.
+    template <typename... Args>
+    bool emplace(Args &&...args) {
+        if (full()) {
+            return false;
+        }
+        new (raw_slot(head)) T(std::forward<Args>(args)...);
+        head = next(head);
+        count++;
+        return true;
+    }
+
+    bool push(const T &value) { return emplace(value); }
+    bool push(T &&value) { return emplace(std::move(value)); }
+
+    // Moves the oldest element out and destroys it in the ring. Returns false when empty.
+    bool pop(T &out) {
+        if (empty()) {
+            return false;
+        }
+        T *element = slot(tail);
+        out = std::move(*element);
+        element->~T();
+        tail = next(tail);
+        count--;
+        return true;
+    }
+
+    // Destroys the oldest element without moving it out - pairs with front()
+    bool pop() {
+        if (empty()) {
+            return false;
+        }
+        slot(tail)->~T();
+        tail = next(tail);
+        count--;
+        return true;
+    }
+
+    // Oldest element, or nullptr when empty - lets the caller inspect it in place
+    T *front() { return empty() ? nullptr : slot(tail); }
+
+    // i-th element counting from the oldest (i < size())
+    T &operator[](size_t i) { return *slot(wrap(tail + i)); }
+    const T &operator[](size_t i) const { return *slot(wrap(tail + i)); }
+
+    // Contiguous run starting at the i-th oldest element (i < size()). Stores its length
+    // in len - whatever is left continues at span(i + len).
+    const T *span(size_t i, size_t &len) const {
+        size_t start = wrap(tail + i);
+        size_t run = N - start;  // Elements before the wrap point
+        len = (run < count - i) ? run : count - i;
+        return slot(start);
+    }
+
+    void clear() {
+        if constexpr (!is_trivial_copy) {
+            while (count > 0) {
+                slot(tail)->~T();
+                tail = next(tail);
+                count--;
+            }
+        }
+        head = tail = count = 0;
+    }
+
+    // Bulk copy of a span - returns how many elements were actually moved
+    size_t write_n(const T *data, size_t len) {
+        if (len > available_space()) {
+            len = available_space();
+        }
+        size_t first = N - head;  // Room before the wrap point
+        if (first > len) {
+            first = len;
+        }
+        if constexpr (is_trivial_copy) {
+            memcpy(raw_slot(head), data, first * sizeof(T));
+            memcpy(raw_slot(0), data + first, (len - first) * sizeof(T));
+        } else {
+            for (size_t i = 0; i < len; i++) {
+                new (raw_slot(wrap(head + i))) T(data[i]);
+            }
+        }
+        head = wrap(head + len);
+        count += len;
+        return len;
+    }
+
+    size_t read_n(T *data, size_t len) {
+        if (len > count) {
+            len = count;
+        }
+        size_t first = N - tail;
+        if (first > len) {
+            first = len;
+        }
+        if constexpr (is_trivial_copy) {
+            memcpy(data, slot(tail), first * sizeof(T));
+            memcpy(data + first, slot(0), (len - first) * sizeof(T));
+        } else {
+            for (size_t i = 0; i < len; i++) {
+                T *element = slot(wrap(tail + i));
+                data[i] = std::move(*element);
+                element->~T();
+            }
+        }
+        tail = wrap(tail + len);
+        count -= len;
+        return len;
+    }
+
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    size_t size() const { return count; }
+    size_t available_space() const { return N - count; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr bool is_trivial_copy = std::is_trivially_copyable<T>::value;
+
+    // Indices never go past 2*N - 1 here, so one compare replaces %
+    static size_t wrap(size_t index) { return (index >= N) ? index - N : index; }
+    static size_t next(size_t index) { return wrap(index + 1); }
+
+    // Slot memory before an element is constructed in it
+    void *raw_slot(size_t index) { return storage + index * sizeof(T); }
+    // Slot holding a live element
+    T *slot(size_t index) { return std::launder(reinterpret_cast<T *>(storage) + index); }
+    const T *slot(size_t index) const {
+        return std::launder(reinterpret_cast<const T *>(storage) + index);
+    }
+
+    alignas(T) unsigned char storage[N * sizeof(T)];  // Raw slots, constructed on demand
+    size_t head;   // Write Index
+    size_t tail;   // Read Index
+    size_t count;  // Number of elements currently in the ring
+};
+
+#endif
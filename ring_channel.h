@@ -0,0 +1,183 @@
+// Ring Channel - C++20 coroutine channel on top of ring<T, N>.
+// co_await ch.write(x) suspends while the ring is full and co_await ch.read() suspends
+// while it is empty, instead of polling cb_read or blocking a thread.
+// A value reaching a suspended reader is handed straight into that reader's awaiter,
+// and a reader that frees a slot moves the first suspended writer's value into the
+// ring, so nothing is copied twice and FIFO order holds.
+// No heap allocation per operation: the awaiters live in the coroutine frames and are
+// linked into intrusive wait lists. Coroutines woken by the channel are passed to a
+// caller-supplied scheduler function (e.g. push onto an executor's run queue); without
+// one they are resumed inline.
+// Like ring<T, N> the channel is not thread-safe: use it from one executor thread.
+// Only compiled with coroutine support (-std=c++20).
+#ifndef RING_CHANNEL_H
+#define RING_CHANNEL_H
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#define RING_CHANNEL_AVAILABLE 1
+#endif
+#endif
+
+#ifdef RING_CHANNEL_AVAILABLE
+
+#include <stddef.h>
+#include <coroutine>
+#include <optional>
+#include <utility>
+#include "ring.h"
+using namespace std;
+
+// Called with each coroutine the channel wakes up - must resume it later, exactly once
+typedef void (*ring_channel_schedule_fn)(void *ctx, coroutine_handle<> handle);
+
+template <typename T, size_t N>
+class ring_channel {
+public:
+    class read_awaiter;
+    class write_awaiter;
+
+    explicit ring_channel(ring_channel_schedule_fn schedule = nullptr, void *ctx = nullptr)
+        : schedule(schedule), ctx(ctx), is_closed(false) {}
+
+    ring_channel(const ring_channel &) = delete;
+    ring_channel &operator=(const ring_channel &) = delete;
+
+    // co_await ch.read() -> optional<T>; empty once the channel is closed and drained
+    read_awaiter read() { return read_awaiter(this); }
+    // co_await ch.write(x) -> bool; false if the channel is (or gets) closed
+    write_awaiter write(const T &value) { return write_awaiter(this, value); }
+    write_awaiter write(T &&value) { return write_awaiter(this, std::move(value)); }
+
+    // Wakes every waiter: readers still drain what is buffered, writers get false.
+    // Suspended coroutines must not be destroyed while they wait - close first.
+    void close() {
+        is_closed = true;
+        while (read_awaiter *r = readers.pop()) {
+            wake(r->handle);
+        }
+        while (write_awaiter *w = writers.pop()) {
+            w->ok = false;
+            wake(w->handle);
+        }
+    }
+
+    bool closed() const { return is_closed; }
+    size_t size() const { return buffer.size(); }
+    static constexpr size_t capacity() { return N; }
+
+    class read_awaiter {
+    public:
+        explicit read_awaiter(ring_channel *channel) : channel(channel), next(nullptr) {}
+        bool await_ready() { return channel->take(value); }
+        void await_suspend(coroutine_handle<> h) {
+            handle = h;
+            channel->readers.push(this);
+        }
+        optional<T> await_resume() { return std::move(value); }
+
+    private:
+        friend class ring_channel;
+        ring_channel *channel;
+        optional<T> value;          // Filled directly by a writer while suspended
+        read_awaiter *next;         // Wait list link
+        coroutine_handle<> handle;
+    };
+
+    class write_awaiter {
+    public:
+        template <typename U>
+        write_awaiter(ring_channel *channel, U &&value)
+            : channel(channel), value(std::forward<U>(value)), ok(true), next(nullptr) {}
+        bool await_ready() { return channel->give(value, ok); }
+        void await_suspend(coroutine_handle<> h) {
+            handle = h;
+            channel->writers.push(this);
+        }
+        bool await_resume() { return ok; }
+
+    private:
+        friend class ring_channel;
+        ring_channel *channel;
+        T value;                    // Moved into the ring or a reader when there is room
+        bool ok;
+        write_awaiter *next;
+        coroutine_handle<> handle;
+    };
+
+private:
+    // Intrusive FIFO of suspended awaiters
+    template <typename W>
+    struct wait_list {
+        W *head = nullptr;
+        W *tail = nullptr;
+        void push(W *w) {
+            w->next = nullptr;
+            if (tail != nullptr) {
+                tail->next = w;
+            } else {
+                head = w;
+            }
+            tail = w;
+        }
+        W *pop() {
+            W *w = head;
+            if (w != nullptr) {
+                head = w->next;
+                if (head == nullptr) {
+                    tail = nullptr;
+                }
+            }
+            return w;
+        }
+    };
+
+    void wake(coroutine_handle<> handle) {
+        if (schedule != nullptr) {
+            schedule(ctx, handle);
+        } else {
+            handle.resume();
+        }
+    }
+
+    // Reader fast path - true if read() completes without suspending
+    bool take(optional<T> &out) {
+        if (buffer.empty()) {
+            return is_closed;  // Closed and drained: completes with no value
+        }
+        out.emplace(std::move(*buffer.front()));
+        buffer.pop();
+        // Writers only wait while the ring is full: the slot just freed goes to the first one
+        if (write_awaiter *w = writers.pop()) {
+            buffer.push(std::move(w->value));
+            wake(w->handle);
+        }
+        return true;
+    }
+
+    // Writer fast path - true if write() completes without suspending
+    bool give(T &value, bool &ok) {
+        if (is_closed) {
+            ok = false;
+            return true;
+        }
+        // Readers only wait while the ring is empty: hand the value over directly
+        if (read_awaiter *r = readers.pop()) {
+            r->value.emplace(std::move(value));
+            wake(r->handle);
+            return true;
+        }
+        return buffer.push(std::move(value));
+    }
+
+    ring<T, N> buffer;
+    wait_list<read_awaiter> readers;   // Suspended in read(), ring empty
+    wait_list<write_awaiter> writers;  // Suspended in write(), ring full
+    ring_channel_schedule_fn schedule;
+    void *ctx;
+    bool is_closed;
+};
+
+#endif // RING_CHANNEL_AVAILABLE
+
+#endif
@@ -0,0 +1,486 @@
+// Ring Log - persistent flight recorder in an mmap'ed file (POSIX).
+// A circular buffer in a plain array is gone after a crash. Here the records live in a
+// MAP_SHARED file mapping, so whatever was appended survives the process (and, after
+// rl_sync, the machine). Appending is a header + memcpy straight into the mapping -
+// the same cost as cb_write_n plus a CRC32C (SSE4.2 crc32 instruction with -msse4.2,
+// table-driven otherwise).
+// Records are 8-byte aligned, never split across the end of the file (a wrap marker
+// sends the reader back to offset 0) and carry a header with a magic, the length, a
+// sequence number and a CRC32C. When the log is full the oldest records are dropped.
+// head/tail are not stored anywhere: rl_open rebuilds them by scanning forward from
+// offset 0 for the chain of newest records, then past its end for the older chain that
+// wraps into it. A torn record (crash in the middle of an append) fails its checksum
+// and is ignored. Records that were dropped but not yet overwritten may come back.
+// The next sequence number is kept in the file header on every commit, so numbers are
+// never handed out twice even if a crash leaves none of the newest records readable.
+// Numbers lost that way leave a gap; each record stores the gap to its predecessor, so
+// the records written after the crash still chain onto the ones before it.
+// Single writer; one process at a time opens the log.
+#ifndef RING_LOG_H
+#define RING_LOG_H
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+using namespace std;
+
+#define RL_FILE_MAGIC 0x474C5252u    // "RRLG" - file holds a ring log
+#define RL_RECORD_MAGIC 0x43455252u  // "RREC" - start of a record
+#define RL_VERSION 1u
+#define RL_WRAP 0xFFFFFFFFu          // Record length meaning "rest of the data area unused"
+
+// Offset 0 of the file - geometry and the sequence high-water mark; head/tail are
+// recovered by scanning
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t data_size;    // Bytes in the data area, multiple of 8
+    uint64_t data_offset;  // Data area, counted from the start of the file
+    uint64_t next_seq;     // Above every committed sequence number (0 = not written yet)
+    uint8_t reserved[32];  // Pads the header to 64 bytes
+} rl_file_header_t;
+
+// In front of every record (and of every wrap marker)
+typedef struct {
+    uint32_t magic;     // RL_RECORD_MAGIC
+    uint32_t len;       // Payload bytes, or RL_WRAP
+    uint64_t seq;       // Sequence number (a wrap marker holds the next record's)
+    uint32_t crc;       // CRC32C of len, seq, gap and the payload
+    uint32_t gap;       // Sequence numbers lost (crash) between the previous record and this one
+} rl_record_header_t;
+
+#define RL_HEADER_SIZE sizeof(rl_record_header_t)
+
+// Process-local handle
+typedef struct {
+    rl_file_header_t *file;  // Start of the mapping
+    uint8_t *data;           // Data area
+    size_t size;             // Data area size
+    size_t map_size;
+    size_t head;             // Where the next record goes
+    size_t tail;             // Oldest record
+    size_t used;             // Bytes taken by records and skipped space at the end
+    size_t records;          // Records between tail and head
+    uint64_t next_seq;       // Sequence number of the next record
+    uint64_t link_seq;       // Newest record's sequence number + 1 (below next_seq after a loss)
+    size_t reserved_len;     // Payload length of the open reservation
+    bool reserving;          // A reservation is open (rl_reserve called, rl_commit not yet)
+} ring_log_t;
+
+// Walks the records from oldest to newest
+typedef struct {
+    size_t offset;
+    size_t remaining;
+} rl_iter_t;
+
+// Function Declarations:
+// File size for a data area of size bytes
+static inline size_t rl_file_size(size_t size);
+// Opens the log in fd: an empty file is formatted with a data area of size bytes, a file
+// that already holds a log is mapped and recovered (size is ignored). Anything else fails.
+static inline bool rl_open(ring_log_t *log, int fd, size_t size);
+static inline void rl_close(ring_log_t *log);
+// Flushes the mapping to storage (msync) - appends survive a process crash without it
+static inline bool rl_sync(ring_log_t *log);
+
+// Writer: room for len payload bytes inside the file (drops the oldest records if needed),
+// then commit - the record only counts once committed. NULL if len can never fit.
+static inline uint8_t* rl_reserve(ring_log_t *log, size_t len);
+static inline bool rl_commit(ring_log_t *log, size_t len);
+static inline bool rl_append(ring_log_t *log, const void *data, size_t len);
+
+// Reader: payloads in place, oldest first. NULL once every record has been visited.
+static inline void rl_iter_init(ring_log_t *log, rl_iter_t *it);
+static inline const uint8_t* rl_iter_next(ring_log_t *log, rl_iter_t *it, size_t *len, uint64_t *seq);
+static inline size_t rl_record_count(ring_log_t *log);
+
+// CRC32C (Castagnoli), chainable: crc = rl_crc32c(crc, next_bytes, n), starting from 0
+static inline uint32_t rl_crc32c(uint32_t crc, const void *data, size_t len);
+
+// Helper Functions:
+#if !defined(__SSE4_2__)
+// Byte-at-a-time table, built once on first use
+struct rl_crc_table_t {
+    uint32_t entries[256];
+    rl_crc_table_t() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78u : 0);  // Reflected Castagnoli polynomial
+            }
+            entries[i] = crc;
+        }
+    }
+};
+#endif
+
+static inline size_t rl_record_size(size_t len) {
+    return (RL_HEADER_SIZE + len + 7) & ~(size_t)7;
+}
+
+static inline rl_record_header_t rl_header_at(ring_log_t *log, size_t offset) {
+    rl_record_header_t header;
+    memcpy(&header, log->data + offset, RL_HEADER_SIZE);
+    return header;
+}
+
+static inline uint32_t rl_record_crc(uint32_t len, uint64_t seq, uint32_t gap, const uint8_t *payload, size_t payload_len) {
+    uint32_t crc = rl_crc32c(0, &len, sizeof(len));
+    crc = rl_crc32c(crc, &seq, sizeof(seq));
+    crc = rl_crc32c(crc, &gap, sizeof(gap));
+    return rl_crc32c(crc, payload, payload_len);
+}
+
+// Header of the next record (or of the wrap marker in front of it), checksum still missing
+static inline rl_record_header_t rl_next_header(ring_log_t *log, uint32_t len) {
+    // The gap is at most the records one crash can lose, far below 2^32
+    rl_record_header_t header = {RL_RECORD_MAGIC, len, log->next_seq, 0, (uint32_t)(log->next_seq - log->link_seq)};
+    return header;
+}
+
+// True when a record can not start at offset: too close to the end for a header, or a
+// wrap marker - the next record is at 0
+static inline bool rl_is_wrap(ring_log_t *log, size_t offset) {
+    return log->size - offset < RL_HEADER_SIZE || rl_header_at(log, offset).len == RL_WRAP;
+}
+
+// If the oldest record is behind a wrap, move the tail to it and release the skipped space
+static inline void rl_skip_wrap(ring_log_t *log) {
+    if (log->records > 0 && rl_is_wrap(log, log->tail)) {
+        log->used -= log->size - log->tail;
+        log->tail = 0;
+    }
+}
+
+// Drops the oldest record
+static inline void rl_evict_oldest(ring_log_t *log) {
+    rl_skip_wrap(log);
+    size_t record_size = rl_record_size(rl_header_at(log, log->tail).len);
+    log->tail += record_size;
+    if (log->tail == log->size) {
+        log->tail = 0;
+    }
+    log->used -= record_size;
+    log->records--;
+    if (log->records == 0) {
+        log->tail = log->head;  // Only skipped space was left
+        log->used = 0;
+    }
+}
+
+// Result of following a chain of valid records from one offset, each one the direct
+// successor of the one before (seq == previous seq + 1 + gap)
+typedef struct {
+    size_t count;        // Records in the chain
+    size_t end;          // Offset just past the last one
+    uint64_t first_seq;
+    uint64_t link_seq;   // next_seq of the record the first one was written after
+    uint64_t next_seq;   // Last sequence number + 1
+    bool wrapped;        // Chain runs into the end of the data area
+} rl_chain_t;
+
+static inline rl_chain_t rl_walk(ring_log_t *log, size_t offset) {
+    rl_chain_t chain = {0, offset, 0, 0, 0, false};
+    for (;;) {
+        if (log->size - offset < RL_HEADER_SIZE) {
+            chain.wrapped = chain.count > 0;  // No room for another header: implicit wrap
+            break;
+        }
+        rl_record_header_t h = rl_header_at(log, offset);
+        if (h.magic != RL_RECORD_MAGIC || (chain.count > 0 && h.seq != chain.next_seq + h.gap)) {
+            break;
+        }
+        if (h.len == RL_WRAP) {
+            chain.wrapped = chain.count > 0 && h.crc == rl_record_crc(h.len, h.seq, h.gap, NULL, 0);
+            break;
+        }
+        size_t record_size = rl_record_size(h.len);
+        if (record_size > log->size - offset ||
+            h.crc != rl_record_crc(h.len, h.seq, h.gap, log->data + offset + RL_HEADER_SIZE, h.len)) {
+            break;  // Torn or foreign bytes
+        }
+        if (chain.count == 0) {
+            chain.first_seq = h.seq;
+            chain.link_seq = h.seq - h.gap;
+        }
+        chain.count++;
+        chain.next_seq = h.seq + 1;
+        offset += record_size;
+        chain.end = offset;
+        if (offset == log->size) {
+            chain.wrapped = true;
+            break;
+        }
+    }
+    return chain;
+}
+
+// Rebuilds head, tail and the counters from the records in the file.
+static inline void rl_recover(ring_log_t *log) {
+    // Newest records: the chain that starts at offset 0
+    rl_chain_t newest = rl_walk(log, 0);
+    uint64_t next_seq = (log->file->next_seq > 1) ? log->file->next_seq : 1;
+    if (newest.count > 0 && newest.next_seq > next_seq) {
+        next_seq = newest.next_seq;  // Crash between the record header and the file header
+    }
+    if (newest.count > 0 && log->size - newest.end < RL_HEADER_SIZE) {
+        // One pass fills the whole area: full, the next append overwrites offset 0
+        log->head = log->tail = 0;
+        log->used = log->size;
+        log->records = newest.count;
+        log->next_seq = next_seq;
+        log->link_seq = newest.next_seq;
+        return;
+    }
+
+    // Older records: a chain after the newest one that runs into the end of the area (or a
+    // wrap marker). Records never start mid-payload, so a broken chain lets the search
+    // skip to where it broke. Of all such chains the one with the highest sequence numbers
+    // is the live one - any other is left over from an earlier lap. This is looked for
+    // even when the newest chain ends in a wrap marker: the marker may be left over too.
+    rl_chain_t older = {0, 0, 0, 0, 0, false};
+    size_t older_offset = 0;
+    size_t offset = newest.end;
+    while (log->size - offset >= RL_HEADER_SIZE) {
+        rl_chain_t chain = rl_walk(log, offset);
+        if (chain.count > 0 && chain.wrapped && (older.count == 0 || chain.next_seq > older.next_seq)) {
+            older = chain;
+            older_offset = offset;
+        }
+        offset = (chain.count > 0) ? chain.end : offset + 8;
+    }
+
+    log->head = newest.end;
+    log->tail = 0;
+    log->records = newest.count;
+    log->link_seq = newest.next_seq;
+    if (older.count > 0 && newest.count > 0 && older.next_seq == newest.link_seq) {
+        log->tail = older_offset;  // The older chain continues at offset 0
+        log->records += older.count;
+    } else if (older.count > 0 && (newest.count == 0 || older.first_seq >= newest.next_seq)) {
+        // Whatever is at 0 is older than the chain that wraps into it: a crash inside a
+        // reservation there left it behind (or nothing valid is at 0 at all)
+        log->head = 0;
+        log->tail = older_offset;
+        log->records = older.count;
+        log->link_seq = older.next_seq;
+    } else if (newest.count > 0 && newest.wrapped) {
+        // Nothing older: the wrap marker is the one written for the next record, which
+        // goes to offset 0 - the area is full
+        log->head = log->tail = 0;
+        log->used = log->size;
+        log->next_seq = next_seq;
+        return;
+    }
+    if (log->link_seq > next_seq) {
+        next_seq = log->link_seq;
+    }
+    log->next_seq = next_seq;
+
+    if (log->records == 0) {
+        log->head = log->tail = 0;
+        log->used = 0;
+        log->link_seq = next_seq;
+    } else if (log->head > log->tail) {
+        log->used = log->head - log->tail;
+    } else {
+        log->used = log->size - log->tail + log->head;  // Wrapped, skipped space included
+    }
+}
+
+// Function Implementations:
+static inline uint32_t rl_crc32c(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = (uint32_t)_mm_crc32_u64(crc, word);
+    }
+    for (; len > 0; p++, len--) {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+#else
+    static const rl_crc_table_t table;
+    for (; len > 0; p++, len--) {
+        crc = table.entries[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+#endif
+    return ~crc;
+}
+
+static inline size_t rl_file_size(size_t size) {
+    return sizeof(rl_file_header_t) + (size & ~(size_t)7);
+}
+
+static inline bool rl_open(ring_log_t *log, int fd, size_t size) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+    bool create = (st.st_size == 0);
+    size_t map_size = create ? rl_file_size(size) : (size_t)st.st_size;
+    if (map_size < sizeof(rl_file_header_t) + RL_HEADER_SIZE + 8) {
+        return false;  // Not a log, or a data area too small for any record
+    }
+    if (create && ftruncate(fd, (off_t)map_size) != 0) {
+        return false;
+    }
+    void *base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    rl_file_header_t *file = (rl_file_header_t *)base;
+    if (create) {
+        memset(file, 0, sizeof(*file));
+        file->version = RL_VERSION;
+        file->data_size = map_size - sizeof(rl_file_header_t);
+        file->data_offset = sizeof(rl_file_header_t);
+        file->magic = RL_FILE_MAGIC;  // New file is all zeros: no stale records to recover
+    } else if (file->magic != RL_FILE_MAGIC || file->version != RL_VERSION ||
+               file->data_offset < sizeof(rl_file_header_t) || (file->data_size & 7) != 0 ||
+               file->data_offset + file->data_size > map_size) {
+        munmap(base, map_size);
+        return false;
+    }
+
+    log->file = file;
+    log->data = (uint8_t *)base + file->data_offset;
+    log->size = (size_t)file->data_size;
+    log->map_size = map_size;
+    log->reserved_len = 0;
+    log->reserving = false;
+    rl_recover(log);
+    return true;
+}
+
+static inline void rl_close(ring_log_t *log) {
+    if (log->file != NULL) {
+        munmap(log->file, log->map_size);
+    }
+    log->file = NULL;
+    log->data = NULL;
+}
+
+static inline bool rl_sync(ring_log_t *log) {
+    return msync(log->file, log->map_size, MS_SYNC) == 0;
+}
+
+static inline uint8_t* rl_reserve(ring_log_t *log, size_t len) {
+    size_t need = rl_record_size(len);
+    if (len >= RL_WRAP || need > log->size) {
+        return NULL;
+    }
+
+    if (need > log->size - log->head) {
+        // Record does not fit before the end: drop what lives in [head, size), mark it
+        // skipped and start again at 0
+        rl_skip_wrap(log);
+        while (log->records > 0 && log->tail >= log->head) {
+            rl_evict_oldest(log);
+            rl_skip_wrap(log);
+        }
+        if (log->size - log->head >= RL_HEADER_SIZE) {
+            rl_record_header_t marker = rl_next_header(log, RL_WRAP);
+            marker.crc = rl_record_crc(marker.len, marker.seq, marker.gap, NULL, 0);
+            memcpy(log->data + log->head, &marker, RL_HEADER_SIZE);
+        }
+        if (log->records > 0) {
+            log->used += log->size - log->head;
+        } else {
+            log->tail = 0;
+        }
+        log->head = 0;
+    }
+    // Drop the oldest records until [head, head + need) holds no live data
+    rl_skip_wrap(log);
+    while (log->records > 0 && log->tail >= log->head && log->tail < log->head + need) {
+        rl_evict_oldest(log);
+        rl_skip_wrap(log);
+    }
+
+    log->reserved_len = len;
+    log->reserving = true;
+    return log->data + log->head + RL_HEADER_SIZE;
+}
+
+// The header (with the checksum over the payload) is written last.
+static inline bool rl_commit(ring_log_t *log, size_t len) {
+    if (!log->reserving || len > log->reserved_len) {
+        return false;  // Without rl_reserve nothing was evicted to make room
+    }
+    uint8_t *record = log->data + log->head;
+    rl_record_header_t header = rl_next_header(log, (uint32_t)len);
+    header.crc = rl_record_crc(header.len, header.seq, header.gap, record + RL_HEADER_SIZE, len);
+    memcpy(record, &header, RL_HEADER_SIZE);
+
+    size_t record_size = rl_record_size(len);
+    log->head += record_size;
+    if (log->head == log->size) {
+        log->head = 0;
+    }
+    log->used += record_size;
+    log->records++;
+    log->next_seq++;
+    log->link_seq = log->next_seq;
+    log->file->next_seq = log->next_seq;  // High-water mark for recovery
+    log->reserved_len = 0;
+    log->reserving = false;
+    return true;
+}
+
+static inline bool rl_append(ring_log_t *log, const void *data, size_t len) {
+    uint8_t *payload = rl_reserve(log, len);
+    if (payload == NULL) {
+        return false;
+    }
+    if (len > 0) {
+        memcpy(payload, data, len);  // data may be NULL for an empty record
+    }
+    return rl_commit(log, len);
+}
+
+static inline void rl_iter_init(ring_log_t *log, rl_iter_t *it) {
+    it->offset = log->tail;
+    it->remaining = log->records;
+}
+
+static inline const uint8_t* rl_iter_next(ring_log_t *log, rl_iter_t *it, size_t *len, uint64_t *seq) {
+    if (it->remaining == 0) {
+        return NULL;
+    }
+    if (rl_is_wrap(log, it->offset)) {
+        it->offset = 0;
+    }
+    rl_record_header_t header = rl_header_at(log, it->offset);
+    const uint8_t *payload = log->data + it->offset + RL_HEADER_SIZE;
+    *len = header.len;
+    if (seq != NULL) {
+        *seq = header.seq;
+    }
+    it->offset += rl_record_size(header.len);
+    if (it->offset == log->size) {
+        it->offset = 0;
+    }
+    it->remaining--;
+    return payload;
+}
+
+static inline size_t rl_record_count(ring_log_t *log) {
+    return log->records;
+}
+
+#endif // __unix__ || __APPLE__
+
+#endif
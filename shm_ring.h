@@ -0,0 +1,228 @@
+// Shared-memory inter-process ring buffer - Linux/POSIX.
+// circular_buffer_t stores a raw pointer to its storage, which means nothing in another
+// process. Here the control header and the data both live inside one shared segment
+// (shm_open or memfd) and the header only holds offsets, so every process can map the
+// segment at whatever address it gets and still agree on the ring.
+// The caller creates/opens the file descriptor (shm_open, memfd_create + fd passing,
+// fork) - this header only sizes, maps and initialises it. After attaching, the fast
+// path is plain loads/stores and acquire/release atomics on the shared header: no
+// syscalls and no copies when the zero-copy calls are used.
+// One producer process and one consumer process (SPSC), same index scheme as
+// spsc_buffer_t: indices run over [0, 2*size) so no counter is shared.
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "circular_buffer.h"
+using namespace std;
+
+#define SHM_RING_MAGIC 0x53524E47u  // "SRNG" - marks a fully initialised header
+#define SHM_RING_VERSION 1u
+
+// Lives at offset 0 of the shared segment. Fixed-width fields only, so processes built
+// for the same architecture agree on the layout.
+typedef struct {
+    uint32_t magic;        // SHM_RING_MAGIC once initialised (stored last)
+    uint32_t version;      // SHM_RING_VERSION
+    uint64_t size;         // Size of the data area (bytes)
+    uint64_t data_offset;  // Data area, counted from the start of the segment
+    alignas(64) uint64_t head;  // Write index in [0, 2*size) - producer process only
+    alignas(64) uint64_t tail;  // Read index in [0, 2*size) - consumer process only
+} shm_ring_header_t;
+
+// Process-local handle - never placed in shared memory
+typedef struct {
+    shm_ring_header_t *header;  // Start of this process's mapping
+    uint8_t *data;              // header + data_offset in this process
+    size_t map_size;            // Length of the mapping
+} shm_ring_t;
+
+// Function Declarations:
+// Total segment size needed for a data area of size bytes
+static inline size_t shm_ring_segment_size(size_t size);
+// Sizes the segment behind fd, maps it and initialises the header (creator only)
+static inline bool shm_ring_create(shm_ring_t *r, int fd, size_t size);
+// Maps an already created segment and validates its header
+static inline bool shm_ring_attach(shm_ring_t *r, int fd);
+static inline void shm_ring_detach(shm_ring_t *r);
+
+// Producer process
+static inline size_t shm_ring_write_reserve(shm_ring_t *r, cb_region_t regions[2]);
+static inline bool shm_ring_write_commit(shm_ring_t *r, size_t len);
+static inline size_t shm_ring_write_n(shm_ring_t *r, const uint8_t *data, size_t len);
+// Consumer process
+static inline size_t shm_ring_read_peek(shm_ring_t *r, cb_region_t regions[2]);
+static inline bool shm_ring_read_consume(shm_ring_t *r, size_t len);
+static inline size_t shm_ring_read_n(shm_ring_t *r, uint8_t *data, size_t len);
+
+// Helper Functions:
+static inline size_t shm_ring_slot(const shm_ring_header_t *h, uint64_t index) {
+    return (size_t)((index >= h->size) ? index - h->size : index);
+}
+
+static inline uint64_t shm_ring_advance(const shm_ring_header_t *h, uint64_t index, size_t len) {
+    index += len;
+    return (index >= 2 * h->size) ? index - 2 * h->size : index;
+}
+
+static inline size_t shm_ring_distance(const shm_ring_header_t *h, uint64_t head, uint64_t tail) {
+    return (size_t)((head >= tail) ? head - tail : head + 2 * h->size - tail);
+}
+
+// Splits len bytes starting at index into the part before the end of the data area and
+// the part that wraps to its start
+static inline void shm_ring_regions(shm_ring_t *r, uint64_t index, size_t len, cb_region_t regions[2]) {
+    size_t slot = shm_ring_slot(r->header, index);
+    size_t first = (size_t)r->header->size - slot;
+    if (first > len) {
+        first = len;
+    }
+    regions[0].data = r->data + slot;
+    regions[0].len = first;
+    regions[1].data = r->data;
+    regions[1].len = len - first;
+}
+
+// Function Implementations:
+static inline size_t shm_ring_segment_size(size_t size) {
+    return sizeof(shm_ring_header_t) + size;
+}
+
+static inline bool shm_ring_create(shm_ring_t *r, int fd, size_t size) {
+    size_t map_size = shm_ring_segment_size(size);
+    if (size == 0 || ftruncate(fd, (off_t)map_size) != 0) {
+        return false;
+    }
+    void *base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    shm_ring_header_t *h = (shm_ring_header_t *)base;
+    // Withdrawn first when an existing segment is reused: an attacher must not see the old
+    // magic next to a half-rewritten header. The fence keeps the rewrites below behind it.
+    __atomic_store_n(&h->magic, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    h->version = SHM_RING_VERSION;
+    h->size = size;
+    h->data_offset = sizeof(shm_ring_header_t);
+    h->head = 0;
+    h->tail = 0;
+    // Published last: a process that sees the magic sees a complete header
+    __atomic_store_n(&h->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+    r->header = h;
+    r->data = (uint8_t *)base + h->data_offset;
+    r->map_size = map_size;
+    return true;
+}
+
+static inline bool shm_ring_attach(shm_ring_t *r, int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(shm_ring_header_t)) {
+        return false;
+    }
+    size_t map_size = (size_t)st.st_size;
+    void *base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    shm_ring_header_t *h = (shm_ring_header_t *)base;
+    if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC ||
+        h->version != SHM_RING_VERSION ||
+        h->data_offset < sizeof(shm_ring_header_t) ||
+        h->data_offset + h->size > map_size) {
+        munmap(base, map_size);  // Not (yet) a ring, or a corrupt/foreign segment
+        return false;
+    }
+
+    r->header = h;
+    r->data = (uint8_t *)base + h->data_offset;
+    r->map_size = map_size;
+    return true;
+}
+
+static inline void shm_ring_detach(shm_ring_t *r) {
+    if (r->header != NULL) {
+        munmap(r->header, r->map_size);
+    }
+    r->header = NULL;
+    r->data = NULL;
+}
+
+static inline size_t shm_ring_write_reserve(shm_ring_t *r, cb_region_t regions[2]) {
+    shm_ring_header_t *h = r->header;
+    uint64_t tail = __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+    size_t space = (size_t)h->size - shm_ring_distance(h, h->head, tail);
+    shm_ring_regions(r, h->head, space, regions);
+    return space;
+}
+
+// Release: the bytes written into the reserved regions become visible to the consumer
+// process together with the new head.
+static inline bool shm_ring_write_commit(shm_ring_t *r, size_t len) {
+    shm_ring_header_t *h = r->header;
+    uint64_t tail = __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+    if (len > h->size - shm_ring_distance(h, h->head, tail)) {
+        return false;
+    }
+    __atomic_store_n(&h->head, shm_ring_advance(h, h->head, len), __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline size_t shm_ring_read_peek(shm_ring_t *r, cb_region_t regions[2]) {
+    shm_ring_header_t *h = r->header;
+    uint64_t head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+    size_t count = shm_ring_distance(h, head, h->tail);
+    shm_ring_regions(r, h->tail, count, regions);
+    return count;
+}
+
+static inline bool shm_ring_read_consume(shm_ring_t *r, size_t len) {
+    shm_ring_header_t *h = r->header;
+    uint64_t head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+    if (len > shm_ring_distance(h, head, h->tail)) {
+        return false;
+    }
+    __atomic_store_n(&h->tail, shm_ring_advance(h, h->tail, len), __ATOMIC_RELEASE);
+    return true;
+}
+
+static inline size_t shm_ring_write_n(shm_ring_t *r, const uint8_t *data, size_t len) {
+    cb_region_t regions[2];
+    size_t space = shm_ring_write_reserve(r, regions);
+    if (len > space) {
+        len = space;
+    }
+    size_t first = (len < regions[0].len) ? len : regions[0].len;
+    memcpy(regions[0].data, data, first);
+    memcpy(regions[1].data, data + first, len - first);
+    shm_ring_write_commit(r, len);
+    return len;
+}
+
+static inline size_t shm_ring_read_n(shm_ring_t *r, uint8_t *data, size_t len) {
+    cb_region_t regions[2];
+    size_t count = shm_ring_read_peek(r, regions);
+    if (len > count) {
+        len = count;
+    }
+    size_t first = (len < regions[0].len) ? len : regions[0].len;
+    memcpy(data, regions[0].data, first);
+    memcpy(data + first, regions[1].data, len - first);
+    shm_ring_read_consume(r, len);
+    return len;
+}
+
+#endif // __linux__
+
+#endif
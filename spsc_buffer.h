@@ -0,0 +1,352 @@
+// Single-Producer/Single-Consumer (SPSC) variant of the circular buffer.
+// circular_buffer_t keeps a shared count that both cb_write and cb_read modify, so a
+// producer thread and a consumer thread need a mutex around it. Here the producer only
+// ever writes head and the consumer only ever writes tail, so the two sides can run on
+// different threads (or main loop vs ISR) with no locks at all.
+// Full vs empty is told apart without a counter by letting the indices run over
+// [0, 2*size): the buffer is empty when head == tail and full when they are exactly
+// size apart. No division is needed to wrap them either.
+// Same caller-provided storage model as cb_init.
+// Overwrite mode (spsc_set_overwrite) keeps the newest data: a write to a full buffer
+// moves tail past the oldest byte. tail then has two writers, so in that mode both sides
+// advance it with compare-and-swap instead of a plain store - still lock-free.
+// Layout: by default the producer-owned fields and the consumer-owned fields sit on
+// separate cache lines, so the two cores do not bounce one line back and forth on every
+// byte. Each side also keeps a cached copy of the other side's index and only reloads
+// the real one when the cached value says full/empty. MCUs without a data cache can
+// define SPSC_PACKED_LAYOUT to drop the padding and save the RAM.
+// Blocking (Linux): spsc_read_blocking/spsc_write_blocking spin for a while and then
+// park on a futex keyed on the other side's index word, instead of burning a core
+// polling spsc_is_empty. The waking side only makes a syscall when someone is parked.
+#ifndef SPSC_BUFFER_H
+#define SPSC_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+using namespace std;
+
+#ifndef SPSC_CACHE_LINE_SIZE
+#define SPSC_CACHE_LINE_SIZE 64
+#endif
+
+#ifdef SPSC_PACKED_LAYOUT
+#define SPSC_LINE_ALIGN
+#else
+#define SPSC_LINE_ALIGN alignas(SPSC_CACHE_LINE_SIZE)
+#endif
+
+typedef struct {
+    // Read-only after init - shared by both sides without any traffic
+    uint8_t *buffer;  // Pointer to caller-provided storage
+    size_t size;      // Size of entire buffer
+    bool overwrite;   // Overwrite (lossy) mode - set before the threads start
+
+    // Producer-owned line
+    SPSC_LINE_ALIGN size_t head;  // Write index in [0, 2*size) - only the producer stores it
+    size_t tail_cache;            // Producer's last seen tail
+    size_t dropped;               // Bytes lost to overwrite mode, stored by the producer only
+    uint32_t consumer_parked;     // Set by a consumer about to sleep on head (read here
+                                  // on every blocking write, written only when parking)
+    uint32_t producer_spin;       // Adaptive spin budget of spsc_write_blocking
+
+    // Consumer-owned line
+    SPSC_LINE_ALIGN size_t tail;  // Read index in [0, 2*size) - only the consumer stores it,
+                                  // except in overwrite mode where the producer may CAS it
+    size_t head_cache;            // Consumer's last seen head
+    uint32_t producer_parked;     // Set by a producer about to sleep on tail
+    uint32_t consumer_spin;       // Adaptive spin budget of spsc_read_blocking
+} spsc_buffer_t;
+
+// Spin budget bounds for the blocking calls (iterations of a CPU pause)
+#ifndef SPSC_SPIN_MIN
+#define SPSC_SPIN_MIN 16
+#endif
+#ifndef SPSC_SPIN_MAX
+#define SPSC_SPIN_MAX 4096
+#endif
+
+// Function Declarations:
+static inline void spsc_init(spsc_buffer_t *sb, uint8_t *buffer, size_t size);
+// Must be called before the producer and consumer threads are started
+static inline void spsc_set_overwrite(spsc_buffer_t *sb, bool enable);
+// Producer side
+static inline bool spsc_write(spsc_buffer_t *sb, uint8_t data);
+// Consumer side
+static inline bool spsc_read(spsc_buffer_t *sb, uint8_t *data);
+static inline bool spsc_read_overwrite(spsc_buffer_t *sb, uint8_t *data);
+
+// Safe from either side, but the answer may be stale by the time the caller looks at it
+static inline bool spsc_is_empty(spsc_buffer_t *sb);
+static inline bool spsc_is_full(spsc_buffer_t *sb);
+static inline size_t spsc_available_space(spsc_buffer_t *sb);
+static inline size_t spsc_data_count(spsc_buffer_t *sb);
+static inline size_t spsc_dropped_count(spsc_buffer_t *sb);
+
+#ifdef __linux__
+// Blocking versions - wait until the byte could be written/read. A blocking reader must
+// be paired with a producer that uses spsc_write_blocking (or calls spsc_notify_consumer
+// after spsc_write), and vice versa, since only those issue the wake-up.
+static inline void spsc_write_blocking(spsc_buffer_t *sb, uint8_t data);
+static inline void spsc_read_blocking(spsc_buffer_t *sb, uint8_t *data);
+static inline void spsc_notify_consumer(spsc_buffer_t *sb);
+static inline void spsc_notify_producer(spsc_buffer_t *sb);
+#endif
+
+// Helper Functions:
+// Moves an index one step forward inside [0, 2*size) - compare instead of %.
+static inline size_t spsc_next(const spsc_buffer_t *sb, size_t index) {
+    index++;
+    return (index == 2 * sb->size) ? 0 : index;
+}
+// Maps an index in [0, 2*size) to its slot in the storage array
+static inline size_t spsc_slot(const spsc_buffer_t *sb, size_t index) {
+    return (index >= sb->size) ? index - sb->size : index;
+}
+// Number of bytes between tail and head, accounting for the index wrap
+static inline size_t spsc_distance(const spsc_buffer_t *sb, size_t head, size_t tail) {
+    return (head >= tail) ? head - tail : head + 2 * sb->size - tail;
+}
+
+// Function Implementations:
+// Must be called before the producer and consumer threads are started.
+static inline void spsc_init(spsc_buffer_t *sb, uint8_t *buffer, size_t size) {
+    sb->buffer = buffer;
+    sb->size = size;
+    sb->head = 0;
+    sb->tail = 0;
+    sb->tail_cache = 0;
+    sb->head_cache = 0;
+    sb->overwrite = false;
+    sb->dropped = 0;
+    sb->consumer_parked = 0;
+    sb->producer_parked = 0;
+    sb->producer_spin = SPSC_SPIN_MIN;
+    sb->consumer_spin = SPSC_SPIN_MIN;
+}
+
+static inline void spsc_set_overwrite(spsc_buffer_t *sb, bool enable) {
+    sb->overwrite = enable;
+}
+
+// Producer: the data byte is stored before head is published with release ordering,
+// so a consumer that sees the new head (acquire) is guaranteed to see the byte too.
+// The cached tail can only be behind the real one, so it can only make us think the
+// buffer is fuller than it is - the consumer's line is touched only in that case.
+static inline bool spsc_write(spsc_buffer_t *sb, uint8_t data) {
+    size_t head = sb->head;  // Own index - no other thread writes it
+    size_t tail = sb->tail_cache;
+
+    if (spsc_distance(sb, head, tail) == sb->size) {
+        tail = __atomic_load_n(&sb->tail, __ATOMIC_ACQUIRE);
+        sb->tail_cache = tail;
+    }
+    if (spsc_distance(sb, head, tail) == sb->size) {
+        if (!sb->overwrite) {
+            return false;  // Full
+        }
+        // Overwrite mode: claim the oldest slot by moving tail past it. If the CAS fails
+        // the consumer has just read that byte, which frees the slot just the same.
+        if (__atomic_compare_exchange_n(&sb->tail, &tail, spsc_next(sb, tail), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&sb->dropped, sb->dropped + 1, __ATOMIC_RELAXED);
+            tail = spsc_next(sb, tail);
+        }
+        sb->tail_cache = tail;  // On failure the CAS loaded the consumer's newer tail
+    }
+    if (sb->overwrite) {
+        // A consumer holding a stale tail may be loading this slot right now - it will
+        // see its CAS fail and discard the value, but the accesses must be atomic
+        __atomic_store_n(&sb->buffer[spsc_slot(sb, head)], data, __ATOMIC_RELAXED);
+    } else {
+        sb->buffer[spsc_slot(sb, head)] = data;
+    }
+    __atomic_store_n(&sb->head, spsc_next(sb, head), __ATOMIC_RELEASE);
+    return true;
+}
+
+// Consumer: mirror image of spsc_write. The slot is read before tail is released back
+// to the producer, so the producer cannot overwrite it while we are still reading.
+static inline bool spsc_read(spsc_buffer_t *sb, uint8_t *data) {
+    if (sb->overwrite) {
+        return spsc_read_overwrite(sb, data);  // tail is shared with the producer
+    }
+    size_t tail = sb->tail;  // Own index
+    size_t head = sb->head_cache;
+
+    if (head == tail) {
+        head = __atomic_load_n(&sb->head, __ATOMIC_ACQUIRE);
+        sb->head_cache = head;
+        if (head == tail) {
+            return false;  // Empty
+        }
+    }
+    *data = sb->buffer[spsc_slot(sb, tail)];
+    __atomic_store_n(&sb->tail, spsc_next(sb, tail), __ATOMIC_RELEASE);
+    return true;
+}
+
+// Consumer in overwrite mode: load the byte, then claim it by CAS on tail. A failed CAS
+// means the producer dropped that byte (and may already be reusing the slot), so the
+// value is discarded and the read is retried from the new tail.
+// As with any bounded index, a CAS could wrongly succeed if the producer laps the whole
+// index range (2*size writes) between our load and our CAS - i.e. only if the consumer
+// is stalled for that long in the middle of a read.
+static inline bool spsc_read_overwrite(spsc_buffer_t *sb, uint8_t *data) {
+    size_t tail = __atomic_load_n(&sb->tail, __ATOMIC_ACQUIRE);
+    for (;;) {
+        // No cached head here: the producer can push tail past any cached value, after
+        // which the cache can no longer tell empty from non-empty
+        size_t head = __atomic_load_n(&sb->head, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            return false;
+        }
+        uint8_t value = __atomic_load_n(&sb->buffer[spsc_slot(sb, tail)], __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&sb->tail, &tail, spsc_next(sb, tail), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *data = value;
+            return true;
+        }
+    }
+}
+
+// Tail is loaded first: both indices only move forward, so the result can overshoot
+// (never undershoot) when the other side moves in between - clamp it to the size.
+static inline size_t spsc_data_count(spsc_buffer_t *sb) {
+    size_t tail = __atomic_load_n(&sb->tail, __ATOMIC_ACQUIRE);
+    size_t head = __atomic_load_n(&sb->head, __ATOMIC_ACQUIRE);
+    size_t count = spsc_distance(sb, head, tail);
+    return (count > sb->size) ? sb->size : count;
+}
+
+static inline size_t spsc_dropped_count(spsc_buffer_t *sb) {
+    return __atomic_load_n(&sb->dropped, __ATOMIC_RELAXED);
+}
+
+static inline size_t spsc_available_space(spsc_buffer_t *sb) {
+    return sb->size - spsc_data_count(sb);
+}
+
+static inline bool spsc_is_empty(spsc_buffer_t *sb) {
+    return spsc_data_count(sb) == 0;
+}
+
+static inline bool spsc_is_full(spsc_buffer_t *sb) {
+    return spsc_data_count(sb) == sb->size;
+}
+
+#ifdef __linux__
+// Helper Functions (blocking):
+static inline void spsc_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// futex words are 32 bits. The indices stay below 2*size, so as long as size < 2^31
+// the low half of an index word identifies its value and can be waited on directly.
+static inline uint32_t *spsc_futex_word(size_t *index) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return (uint32_t *)index + (sizeof(size_t) / sizeof(uint32_t) - 1);
+#else
+    return (uint32_t *)index;
+#endif
+}
+
+// Sleeps until *word changes from expected (or a spurious wake-up - callers re-check)
+static inline void spsc_futex_wait(uint32_t *word, uint32_t expected) {
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static inline void spsc_futex_wake(uint32_t *word) {
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+// Spin budget grows when spinning paid off and shrinks when we had to sleep anyway
+static inline uint32_t spsc_spin_adjust(uint32_t budget, bool spin_worked) {
+    if (spin_worked) {
+        return (budget < SPSC_SPIN_MAX) ? budget * 2 : budget;
+    }
+    return (budget > SPSC_SPIN_MIN) ? budget / 2 : budget;
+}
+
+// Wake-up protocol (both directions): the sleeper sets its parked flag, issues a full
+// fence and re-checks the index before sleeping; the waker publishes the index, issues
+// a full fence and only then reads the flag. One of the two is guaranteed to see the
+// other's store, so a wake-up is never lost - and when nobody is parked the waker pays
+// for a fence and one load of its own cache line, but no syscall.
+static inline void spsc_notify_consumer(spsc_buffer_t *sb) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sb->consumer_parked, __ATOMIC_RELAXED)) {
+        spsc_futex_wake(spsc_futex_word(&sb->head));
+    }
+}
+
+static inline void spsc_notify_producer(spsc_buffer_t *sb) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sb->producer_parked, __ATOMIC_RELAXED)) {
+        spsc_futex_wake(spsc_futex_word(&sb->tail));
+    }
+}
+
+static inline void spsc_write_blocking(spsc_buffer_t *sb, uint8_t data) {
+    uint32_t budget = sb->producer_spin;
+    for (uint32_t i = 0; i < budget; i++) {
+        if (spsc_write(sb, data)) {
+            if (i > 0) {
+                sb->producer_spin = spsc_spin_adjust(budget, true);
+            }
+            spsc_notify_consumer(sb);
+            return;
+        }
+        spsc_cpu_relax();
+    }
+    sb->producer_spin = spsc_spin_adjust(budget, false);
+
+    while (!spsc_write(sb, data)) {
+        __atomic_store_n(&sb->producer_parked, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        size_t tail = __atomic_load_n(&sb->tail, __ATOMIC_RELAXED);
+        if (spsc_distance(sb, sb->head, tail) == sb->size) {
+            spsc_futex_wait(spsc_futex_word(&sb->tail), (uint32_t)tail);  // Still full
+        }
+        __atomic_store_n(&sb->producer_parked, 0, __ATOMIC_RELAXED);
+    }
+    spsc_notify_consumer(sb);
+}
+
+static inline void spsc_read_blocking(spsc_buffer_t *sb, uint8_t *data) {
+    uint32_t budget = sb->consumer_spin;
+    for (uint32_t i = 0; i < budget; i++) {
+        if (spsc_read(sb, data)) {
+            if (i > 0) {
+                sb->consumer_spin = spsc_spin_adjust(budget, true);
+            }
+            spsc_notify_producer(sb);
+            return;
+        }
+        spsc_cpu_relax();
+    }
+    sb->consumer_spin = spsc_spin_adjust(budget, false);
+
+    while (!spsc_read(sb, data)) {
+        __atomic_store_n(&sb->consumer_parked, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        size_t head = __atomic_load_n(&sb->head, __ATOMIC_RELAXED);
+        if (head == __atomic_load_n(&sb->tail, __ATOMIC_RELAXED)) {
+            spsc_futex_wait(spsc_futex_word(&sb->head), (uint32_t)head);  // Still empty
+        }
+        __atomic_store_n(&sb->consumer_parked, 0, __ATOMIC_RELAXED);
+    }
+    spsc_notify_producer(sb);
+}
+#endif // __linux__
+
+#endif
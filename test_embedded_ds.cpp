@@ -1,8 +1,22 @@
 #include <iostream>
 #include <cassert>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <memory>
+#include <vector>
+#ifdef __linux__
+#include <sys/wait.h>
+#include <fcntl.h>
+#endif
 #include "embedded_ds.h"
 using namespace std;
 
+// Watermark callback for the tests: appends H or L to a string
+static void cb_test_record_event(void *ctx, int event) {
+    *(string *)ctx += (event == CB_WATERMARK_HIGH) ? 'H' : 'L';
+}
+
 // Test functions
 void test_circular_buffer() {
     cout << "Testing Circular Buffer...\n";
@@ -32,8 +46,1597 @@ void test_circular_buffer() {
     assert(cb_is_full(&cb) == true);
     assert(cb_write(&cb, 99) == false);
 
+    // Test bulk write/read across the wrap point
+    cb_init(&cb, storage, 5);
+    uint8_t in[4] = {1, 2, 3, 4};
+    uint8_t out[5];
+    assert(cb_write_n(&cb, in, 3) == 3);
+    assert(cb_read_n(&cb, out, 2) == 2 && out[0] == 1 && out[1] == 2);
+    assert(cb_write_n(&cb, in, 4) == 4);  // Wraps: 2 bytes at the end, 2 at the start
+    assert(cb_is_full(&cb) == true);
+    assert(cb_write_n(&cb, in, 1) == 0);
+    assert(cb_read_n(&cb, out, 5) == 5);
+    assert(out[0] == 3 && out[1] == 1 && out[2] == 2 && out[3] == 3 && out[4] == 4);
+    assert(cb_read_n(&cb, out, 1) == 0);
+
+    // Partial transfers are clamped to what fits / what is waiting
+    assert(cb_write_n(&cb, in, 4) == 4);
+    assert(cb_write_n(&cb, in, 4) == 1);
+    assert(cb_read_n(&cb, out, 2) == 2);
+    assert(cb_data_count(&cb) == 3);
+
+    // Test zero-copy reserve/commit and peek/consume
+    cb_init(&cb, storage, 5);
+    cb_region_t regions[2];
+    assert(cb_write_reserve(&cb, regions) == 5);
+    assert(regions[0].data == storage && regions[0].len == 5);
+    assert(regions[1].len == 0);
+    regions[0].data[0] = 7;
+    regions[0].data[1] = 8;
+    assert(cb_write_commit(&cb, 2) == true);
+    assert(cb_write_commit(&cb, 4) == false);  // More than is free
+
+    assert(cb_read_peek(&cb, regions) == 2);
+    assert(regions[0].data == storage && regions[0].len == 2 && regions[0].data[1] == 8);
+    assert(cb_read_consume(&cb, 2) == true);
+
+    assert(cb_write_n(&cb, in, 4) == 4);       // Data now wraps: slots 2-4, then 0
+    assert(cb_read_peek(&cb, regions) == 4);
+    assert(regions[0].data == storage + 2 && regions[0].len == 3);
+    assert(regions[1].data == storage && regions[1].len == 1 && regions[1].data[0] == 4);
+    assert(cb_read_consume(&cb, 5) == false);  // Only 4 bytes waiting
+    assert(cb_read_consume(&cb, 4) == true);
+
+    assert(cb_write_reserve(&cb, regions) == 5);  // Free space wraps: slots 1-4, then 0
+    assert(regions[0].data == storage + 1 && regions[0].len == 4);
+    assert(regions[1].data == storage && regions[1].len == 1);
+
+    // Test power-of-two mode
+    uint8_t storage8[8];
+    assert(cb_init_pow2(&cb, storage8, 6) == false);  // Not a power of two
+    assert(cb_init_pow2(&cb, storage8, 8) == true);
+    for (int i = 0; i < 8; i++) {
+        assert(cb_write(&cb, i) == true);
+    }
+    assert(cb_is_full(&cb) == true && cb_write(&cb, 99) == false);
+    for (int i = 0; i < 8; i++) {
+        assert(cb_read(&cb, &data) == true && data == i);
+    }
+    assert(cb_is_empty(&cb) == true);
+
+    // Free-running indices keep working through size_t overflow
+    cb.head = cb.tail = SIZE_MAX - 2;
+    assert(cb_write_n(&cb, in, 4) == 4);
+    assert(cb_data_count(&cb) == 4 && cb.head == 1);
+    assert(cb_read_peek(&cb, regions) == 4);
+    assert(regions[0].data == storage8 + 5 && regions[0].len == 3);
+    assert(regions[1].data == storage8 && regions[1].len == 1);
+    assert(cb_read_n(&cb, out, 4) == 4 && out[0] == 1 && out[3] == 4);
+    assert(cb_is_empty(&cb) == true);
+
+    // Test overwrite mode - the newest data is kept, the drop counter tracks the rest
+    cb_init(&cb, storage, 5);
+    cb_set_overwrite(&cb, true);
+    for (int i = 0; i < 7; i++) {
+        assert(cb_write(&cb, i) == true);
+    }
+    assert(cb_is_full(&cb) == true && cb_dropped_count(&cb) == 2);
+    assert(cb_read(&cb, &data) == true && data == 2);
+    uint8_t burst[7] = {10, 11, 12, 13, 14, 15, 16};
+    assert(cb_write_n(&cb, burst, 7) == 7);  // Longer than the buffer: last 5 bytes kept
+    assert(cb_dropped_count(&cb) == 2 + 2 + 4);
+    assert(cb_read_n(&cb, out, 5) == 5 && out[0] == 12 && out[4] == 16);
+
+    assert(cb_init_pow2(&cb, storage8, 8) == true);
+    cb_set_overwrite(&cb, true);
+    for (int i = 0; i < 10; i++) {
+        assert(cb_write(&cb, i) == true);
+    }
+    assert(cb_dropped_count(&cb) == 2);
+    assert(cb_read(&cb, &data) == true && data == 2);
+
+    // Test delimiter search (every length crosses the SIMD/scalar boundaries)
+    uint8_t scan_storage[100];
+    uint8_t line[100];
+    size_t offset;
+    for (size_t start = 0; start < 100; start += 37) {
+        for (size_t len = 1; len <= 100; len++) {
+            cb_init(&cb, scan_storage, 100);
+            cb_write_n(&cb, line, start);  // Move head/tail so the data wraps
+            cb_read_n(&cb, line, start);
+            memset(line, 'a', len);
+            line[len - 1] = '\n';
+            assert(cb_write_n(&cb, line, len) == len);
+            assert(cb_find(&cb, '\n', &offset) == true && offset == len - 1);
+            assert(cb_find(&cb, 'z', &offset) == false);
+            const uint8_t markers[2] = {0x7E, '\r'};
+            assert(cb_find_any(&cb, markers, 2, &offset) == false);
+            if (len > 2) {
+                line[len / 2] = 0x7E;
+                cb_read_consume(&cb, len);
+                cb_write_n(&cb, line, len);
+                assert(cb_find_any(&cb, markers, 2, &offset) == true && offset == len / 2);
+                uint8_t many[CB_SCAN_MAX_SET + 4];  // Larger than the SIMD set limit
+                for (size_t k = 0; k < sizeof(many); k++) {
+                    many[k] = (uint8_t)(0x70 + k);  // 0x70..0x83, includes 0x7E
+                }
+                assert(cb_find_any(&cb, many, sizeof(many), &offset) == true && offset == len / 2);
+            }
+            assert(cb_data_count(&cb) == len);  // Nothing consumed by the search
+        }
+    }
+
+    // Test watermarks - one event per crossing, whichever call moved the level
+    {
+        uint8_t wm_storage[16];
+        string events;
+        cb_init(&cb, wm_storage, 16);
+        assert(cb_set_watermarks(&cb, 8, 12, cb_test_record_event, &events) == false);  // low >= high
+        assert(cb_set_watermarks(&cb, 17, 4, cb_test_record_event, &events) == false);  // high > size
+        assert(cb_set_watermarks(&cb, 12, 4, cb_test_record_event, &events) == true);
+
+        uint8_t chunk[16] = {0};
+        cb_write_n(&cb, chunk, 11);
+        assert(events.empty());
+        cb_write(&cb, 1);               // 12: crosses high
+        cb_write_n(&cb, chunk, 3);      // Still above: no repeat
+        assert(events == "H");
+        cb_read_n(&cb, chunk, 10);      // 5: between the marks, nothing yet
+        assert(events == "H");
+        cb_write_n(&cb, chunk, 9);      // Back up to 14 without having gone low: no event
+        assert(events == "H");
+        cb_read_consume(&cb, 10);       // 4: crosses low
+        cb_read(&cb, chunk);
+        assert(events == "HL");
+        cb_region_t regions[2];
+        cb_write_reserve(&cb, regions);
+        cb_write_commit(&cb, 13);       // 16 through the zero-copy path
+        assert(events == "HLH");
+
+        // Overwrite mode keeps the buffer full - dropping the oldest bytes is not a read
+        cb_set_overwrite(&cb, true);
+        cb_write_n(&cb, chunk, 16);
+        cb_write(&cb, 2);
+        assert(events == "HLH");
+        cb_set_overwrite(&cb, false);
+
+        // Already above the new high mark: reported straight away
+        assert(cb_set_watermarks(&cb, 10, 2, cb_test_record_event, &events) == true);
+        assert(events == "HLHH");
+        cb_clear_watermarks(&cb);
+        cb_read_n(&cb, chunk, 16);
+        assert(events == "HLHH");
+
+        // Power-of-two mode goes through the same checks
+        cb_init_pow2(&cb, wm_storage, 16);
+        events.clear();
+        cb_set_watermarks(&cb, 4, 1, cb_test_record_event, &events);
+        for (int i = 0; i < 3; i++) {
+            cb_write_n(&cb, chunk, 4);
+            cb_read_n(&cb, chunk, 4);
+        }
+        assert(events == "HLHLHL");
+
+        // Byte at a time, marks at the very ends (full / empty), in both modes: the
+        // fast-path limits must hand exactly the crossing bytes to the slow path
+        for (int pow2 = 0; pow2 < 2; pow2++) {
+            if (pow2) {
+                cb_init_pow2(&cb, wm_storage, 16);
+            } else {
+                cb_init(&cb, wm_storage, 16);
+            }
+            events.clear();
+            cb_set_watermarks(&cb, 16, 0, cb_test_record_event, &events);
+            for (int round = 0; round < 3; round++) {
+                for (int i = 0; i < 16; i++) {
+                    assert(cb_write(&cb, (uint8_t)(round + i)) == true);
+                    assert(events.size() == (size_t)(2 * round + (i == 15)));
+                }
+                assert(cb_write(&cb, 0) == false);
+                for (int i = 0; i < 16; i++) {
+                    assert(cb_read(&cb, &data) == true && data == (uint8_t)(round + i));
+                    assert(events.size() == (size_t)(2 * round + 1 + (i == 15)));
+                }
+                assert(cb_read(&cb, &data) == false);
+            }
+            assert(events == "HLHLHL");
+            cb_clear_watermarks(&cb);
+            for (int i = 0; i < 16; i++) {
+                cb_write(&cb, 1);
+            }
+            assert(cb_write(&cb, 1) == false && cb_read(&cb, &data) == true && events == "HLHLHL");
+        }
+    }
+
     cout << "Circular Buffer tests passed\n";
 }
+void test_spsc_buffer() {
+    cout << "Testing SPSC Buffer...\n";
+
+    uint8_t storage[5];
+    spsc_buffer_t sb;
+    spsc_init(&sb, storage, 5);
+
+    assert(spsc_is_empty(&sb) == true);
+    assert(spsc_is_full(&sb) == false);
+
+    // Whole capacity is usable - no slot is sacrificed to tell full from empty
+    for (int i = 0; i < 5; i++) {
+        assert(spsc_write(&sb, i) == true);
+    }
+    assert(spsc_is_full(&sb) == true);
+    assert(spsc_write(&sb, 99) == false);
+
+    uint8_t data;
+    assert(spsc_read(&sb, &data) == true && data == 0);
+    assert(spsc_data_count(&sb) == 4);
+
+    // Cycle through the index wrap a few times
+    for (int i = 5; i < 30; i++) {
+        assert(spsc_write(&sb, i) == true);
+        assert(spsc_read(&sb, &data) == true && data == i - 4);
+    }
+
+    // One producer thread, one consumer thread, no locks
+    spsc_init(&sb, storage, 5);
+    const int total = 100000;
+    thread producer([&sb, total]() {
+        for (int i = 0; i < total; i++) {
+            while (!spsc_write(&sb, (uint8_t)i)) {
+                this_thread::yield();
+            }
+        }
+    });
+    for (int i = 0; i < total; i++) {
+        while (!spsc_read(&sb, &data)) {
+            this_thread::yield();
+        }
+        assert(data == (uint8_t)i);
+    }
+    producer.join();
+    assert(spsc_is_empty(&sb) == true);
+
+    // Overwrite mode: the newest 5 bytes survive, older ones are counted as dropped
+    spsc_init(&sb, storage, 5);
+    spsc_set_overwrite(&sb, true);
+    for (int i = 0; i < 8; i++) {
+        assert(spsc_write(&sb, i) == true);
+    }
+    assert(spsc_is_full(&sb) == true && spsc_dropped_count(&sb) == 3);
+    for (int i = 3; i < 8; i++) {
+        assert(spsc_read(&sb, &data) == true && data == i);
+    }
+    assert(spsc_read(&sb, &data) == false);
+
+    // Overwrite mode under concurrency: whatever survives still comes out in order and
+    // every byte is either received or counted as dropped
+    for (int round = 0; round < 200; round++) {
+        spsc_init(&sb, storage, 5);
+        spsc_set_overwrite(&sb, true);
+        const int burst = 250;  // Every value distinct, so order is checkable
+        thread lossy_producer([&sb, burst]() {
+            for (int i = 0; i < burst; i++) {
+                spsc_write(&sb, (uint8_t)i);
+            }
+        });
+        int received = 0;
+        int previous = -1;
+        while (received + (int)spsc_dropped_count(&sb) < burst) {
+            if (spsc_read(&sb, &data)) {
+                assert((int)data > previous);
+                previous = data;
+                received++;
+            }
+        }
+        lossy_producer.join();
+        assert(received + (int)spsc_dropped_count(&sb) == burst);
+    }
+
+#ifdef __linux__
+    // Blocking calls: both sides regularly run out of data/space and park on the futex
+    spsc_init(&sb, storage, 5);
+    thread blocking_producer([&sb]() {
+        for (int i = 0; i < 2000; i++) {
+            spsc_write_blocking(&sb, (uint8_t)i);
+            if (i % 500 == 0) {
+                this_thread::sleep_for(chrono::milliseconds(5));  // Consumer parks on empty
+            }
+        }
+    });
+    for (int i = 0; i < 2000; i++) {
+        spsc_read_blocking(&sb, &data);
+        assert(data == (uint8_t)i);
+        if (i % 700 == 0) {
+            this_thread::sleep_for(chrono::milliseconds(5));  // Producer parks on full
+        }
+    }
+    blocking_producer.join();
+    assert(spsc_is_empty(&sb) == true);
+    assert(sb.consumer_parked == 0 && sb.producer_parked == 0);
+#endif
+
+    cout << "SPSC Buffer tests passed\n";
+}
+#ifdef __linux__
+void test_mirrored_buffer() {
+    cout << "Testing Mirrored Buffer...\n";
+
+    mirrored_buffer_t mb;
+    assert(mb_init(&mb, 1000) == false);  // Not a multiple of the page size
+
+    size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    assert(mb_init(&mb, size) == true);
+
+    // Both views alias the same pages
+    mb.cb.buffer[0] = 0xAB;
+    assert(mb.cb.buffer[size] == 0xAB);
+
+    // Move head/tail close to the end so the next write straddles the wrap point
+    size_t len;
+    uint8_t *region = mb_write_reserve(&mb, &len);
+    assert(region == mb.cb.buffer && len == size);
+    assert(mb_write_commit(&mb, size - 10) == true);
+    assert(mb_read_consume(&mb, size - 10) == true);
+
+    // One contiguous span even though it wraps
+    region = mb_write_reserve(&mb, &len);
+    assert(len == size);
+    for (int i = 0; i < 100; i++) {
+        region[i] = (uint8_t)i;
+    }
+    assert(mb_write_commit(&mb, 100) == true);
+    assert(mb.cb.buffer[0] == 10);  // Bytes past the end landed at the start
+
+    region = mb_read_peek(&mb, &len);
+    assert(len == 100);
+    for (int i = 0; i < 100; i++) {
+        assert(region[i] == (uint8_t)i);
+    }
+    assert(mb_read_consume(&mb, 100) == true);
+    assert(cb_is_empty(&mb.cb) == true);
+
+    mb_destroy(&mb);
+    cout << "Mirrored Buffer tests passed\n";
+}
+#endif
+void test_ring() {
+    cout << "Testing Typed Ring...\n";
+
+    // Trivially copyable element - bulk copies go through memcpy
+    struct sample_t { uint32_t timestamp; float value; };
+    ring<sample_t, 4> samples;
+    assert(samples.empty() == true && samples.capacity() == 4);
+    assert(samples.push(sample_t{1, 1.5f}) == true);
+    assert(samples.emplace(sample_t{2, 2.5f}) == true);
+
+    sample_t batch[3] = {{3, 3.5f}, {4, 4.5f}, {5, 5.5f}};
+    assert(samples.write_n(batch, 3) == 2);  // Only 2 slots left
+    assert(samples.full() == true);
+    assert(samples[3].timestamp == 4);
+
+    sample_t s;
+    assert(samples.pop(s) == true && s.timestamp == 1);
+    assert(samples.write_n(batch + 2, 1) == 1);  // Wraps to slot 0
+    sample_t out[4];
+    assert(samples.read_n(out, 4) == 4);
+    assert(out[0].timestamp == 2 && out[3].timestamp == 5 && out[3].value == 5.5f);
+    assert(samples.pop(s) == false);
+
+    // Non-trivial element - constructed and destroyed in place
+    ring<string, 3> names;
+    assert(names.emplace(5, 'a') == true);  // Built from constructor arguments
+    assert(names.push(string("sensor")) == true);
+    assert(*names.front() == "aaaaa");
+    string name;
+    assert(names.pop(name) == true && name == "aaaaa");
+    string more[3] = {"x", "y", "z"};
+    assert(names.write_n(more, 3) == 2);
+    string got[3];
+    assert(names.read_n(got, 3) == 3);
+    assert(got[0] == "sensor" && got[2] == "y");
+
+    // Move-only element
+    ring<unique_ptr<int>, 2> owners;
+    assert(owners.push(unique_ptr<int>(new int(7))) == true);
+    unique_ptr<int> owner;
+    assert(owners.pop(owner) == true && *owner == 7);
+    assert(owners.empty() == true);
+
+    cout << "Typed Ring tests passed\n";
+}
+// Checks every aggregate of w against a rescan of its samples
+template <typename W>
+static void check_window(W &w) {
+    auto lo = w[0], hi = w[0];
+    typename W::sum_type sum = 0;
+    for (size_t i = 0; i < w.size(); i++) {
+        lo = min(lo, w[i]);
+        hi = max(hi, w[i]);
+        sum += w[i];
+    }
+    assert(w.min() == lo && w.max() == hi);
+    if constexpr (is_floating_point<decltype(lo)>::value) {
+        assert(w.sum() - sum < 1e-6 && sum - w.sum() < 1e-6);
+    } else {
+        assert(w.sum() == sum);
+    }
+}
+
+void test_window_ring() {
+    cout << "Testing Window Ring...\n";
+
+    window_ring<int32_t, 64> w(5);
+    int32_t samples[] = {4, -2, 7, 7, 1, 3, -9, 5, 5, 0};
+    for (int32_t value : samples) {
+        w.push(value);
+    }
+    assert(w.size() == 5 && w.window() == 5);  // Holds the last five: 3 -9 5 5 0
+    assert(w[0] == 3 && w[4] == 0);
+    assert(w.min() == -9 && w.max() == 5 && w.sum() == 4);
+    assert(w.mean() == 0.8);
+
+    // Long random stream, window sliding and resized along the way
+    uint32_t state = 12345;
+    for (int i = 0; i < 5000; i++) {
+        state = state * 1103515245u + 12345u;
+        w.push((int32_t)(state >> 8) % 1000 - 500);
+        check_window(w);
+        if (i == 1000) assert(w.resize(64) == true);   // Grow: fills up over the next pushes
+        if (i == 2000) assert(w.resize(7) == true);    // Shrink: oldest samples dropped
+        if (i == 3000) assert(w.resize(33) == true);
+    }
+    assert(w.size() == 33);
+    assert(w.resize(0) == false && w.resize(65) == false);
+
+    // Descending then ascending runs exercise both queues' pruning
+    window_ring<double, 16> d;
+    for (int i = 0; i < 40; i++) {
+        d.push(i < 20 ? 100.0 - i * 0.5 : i * 0.25);
+        check_window(d);
+    }
+    d.resize(10);
+    check_window(d);
+
+    window_ring<float, 8> f;
+    for (int i = 0; i < 30; i++) {
+        f.push((float)(i % 5) * 1.5f);
+        check_window(f);
+    }
+    f.resize(3);
+    check_window(f);
+
+    window_ring<uint8_t, 4> u;
+    for (int i = 0; i < 10; i++) {
+        u.push((uint8_t)(250 + i % 6));
+        check_window(u);
+    }
+    u.clear();
+    assert(u.empty() && u.sum() == 0);
+
+    cout << "Window Ring tests passed\n";
+}
+
+
+#ifdef RING_CHANNEL_AVAILABLE
+// Fire-and-forget coroutine for the channel tests - frame freed when it finishes
+struct channel_task {
+    struct promise_type {
+        channel_task get_return_object() { return {}; }
+        suspend_never initial_suspend() { return {}; }
+        suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { abort(); }
+    };
+};
+
+// Minimal executor: woken coroutines queue up and run from the loop below
+static void channel_schedule(void *ctx, coroutine_handle<> handle) {
+    ((vector<coroutine_handle<>> *)ctx)->push_back(handle);
+}
+
+static void channel_run(vector<coroutine_handle<>> &run_queue) {
+    while (!run_queue.empty()) {
+        coroutine_handle<> handle = run_queue.front();
+        run_queue.erase(run_queue.begin());
+        handle.resume();
+    }
+}
+
+static channel_task channel_producer(ring_channel<int, 4> &ch, int count, int *suspended) {
+    for (int i = 0; i < count; i++) {
+        bool full = ch.size() == ch.capacity();
+        assert(co_await ch.write(i) == true);
+        *suspended += full;
+    }
+    ch.close();
+}
+
+static channel_task channel_consumer(ring_channel<int, 4> &ch, vector<int> *out) {
+    while (optional<int> value = co_await ch.read()) {
+        out->push_back(*value);
+    }
+}
+
+static channel_task channel_move_reader(ring_channel<unique_ptr<int>, 2> &ch, int *got) {
+    optional<unique_ptr<int>> value = co_await ch.read();
+    *got = **value;
+}
+
+void test_ring_channel() {
+    cout << "Testing Ring Channel...\n";
+
+    vector<coroutine_handle<>> run_queue;
+
+    // Producer runs ahead, fills the ring and suspends until the consumer catches up
+    ring_channel<int, 4> ch(channel_schedule, &run_queue);
+    vector<int> received;
+    int suspended = 0;
+    channel_producer(ch, 100, &suspended);
+    assert(ch.size() == 4);  // Producer is parked on the fifth write
+    channel_consumer(ch, &received);
+    channel_run(run_queue);
+    assert(received.size() == 100);
+    for (int i = 0; i < 100; i++) {
+        assert(received[i] == i);
+    }
+    assert(suspended > 0 && ch.closed());
+
+    // Reader waits first: the value goes straight into it, never into the ring
+    ring_channel<unique_ptr<int>, 2> moves(channel_schedule, &run_queue);
+    int got = 0;
+    channel_move_reader(moves, &got);
+    assert(run_queue.empty() && got == 0);
+    [](ring_channel<unique_ptr<int>, 2> &c) -> channel_task {
+        co_await c.write(make_unique<int>(42));
+    }(moves);
+    assert(moves.size() == 0 && run_queue.size() == 1);  // Reader scheduled, not resumed inline
+    channel_run(run_queue);
+    assert(got == 42);
+
+    // Writes after close fail; a waiting reader wakes with no value
+    ring_channel<int, 4> closing;  // No scheduler: woken coroutines resume inline
+    vector<int> none;
+    channel_consumer(closing, &none);
+    closing.close();
+    assert(none.empty());
+    bool result = true;
+    [](ring_channel<int, 4> &c, bool *r) -> channel_task { *r = co_await c.write(1); }(closing, &result);
+    assert(result == false);
+
+    cout << "Ring Channel tests passed\n";
+}
+#endif
+void test_mpmc_queue() {
+    cout << "Testing MPMC Queue...\n";
+
+    static uint8_t memory[4096];
+    mpmc_queue_t q;
+    assert(mpmc_init(&q, memory, 6, sizeof(uint32_t)) == false);  // Not a power of two
+    assert(mpmc_memory_size(4, sizeof(uint32_t)) <= sizeof(memory));
+    assert(mpmc_init(&q, memory, 4, sizeof(uint32_t)) == true);
+
+    // FIFO order, full and empty detection
+    uint32_t value;
+    assert(mpmc_dequeue(&q, &value) == false);
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(mpmc_enqueue(&q, &i) == true);
+    }
+    uint32_t extra = 99;
+    assert(mpmc_enqueue(&q, &extra) == false);
+    assert(mpmc_dequeue(&q, &value) == true && value == 0);
+
+    // Batches are clamped to what fits / what is waiting, and wrap around
+    uint32_t batch[4] = {10, 11, 12, 13};
+    assert(mpmc_enqueue_n(&q, batch, 4) == 1);
+    uint32_t out[8];
+    assert(mpmc_dequeue_n(&q, out, 8) == 4);
+    assert(out[0] == 1 && out[2] == 3 && out[3] == 10);
+    assert(mpmc_enqueue_n(&q, batch, 3) == 3 && mpmc_size_approx(&q) == 3);
+    assert(mpmc_dequeue_n(&q, out, 2) == 2 && out[1] == 11);
+
+    // 4 producers and 4 consumers: every element arrives exactly once
+    assert(mpmc_init(&q, memory, 64, sizeof(uint32_t)) == true);
+    const uint32_t per_producer = 20000;
+    const int producers = 4;
+    vector<uint8_t> seen(per_producer * producers, 0);
+    size_t consumed[4] = {0, 0, 0, 0};
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&q, p, per_producer]() {
+            for (uint32_t i = 0; i < per_producer; ) {
+                uint32_t items[3];
+                size_t n = (per_producer - i < 3) ? per_producer - i : 3;
+                for (size_t k = 0; k < n; k++) {
+                    items[k] = p * per_producer + i + (uint32_t)k;
+                }
+                size_t done = mpmc_enqueue_n(&q, items, n);
+                i += (uint32_t)done;
+                if (done == 0) {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < 4; c++) {
+        threads.emplace_back([&q, &seen, &consumed, c, per_producer, producers]() {
+            uint32_t got[5];
+            while (__atomic_load_n(&consumed[0], __ATOMIC_RELAXED) +
+                   __atomic_load_n(&consumed[1], __ATOMIC_RELAXED) +
+                   __atomic_load_n(&consumed[2], __ATOMIC_RELAXED) +
+                   __atomic_load_n(&consumed[3], __ATOMIC_RELAXED) < per_producer * producers) {
+                size_t n = mpmc_dequeue_n(&q, got, 5);
+                for (size_t k = 0; k < n; k++) {
+                    seen[got[k]]++;
+                }
+                if (n == 0) {
+                    this_thread::yield();
+                }
+                __atomic_fetch_add(&consumed[c], n, __ATOMIC_RELAXED);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (size_t i = 0; i < seen.size(); i++) {
+        assert(seen[i] == 1);
+    }
+
+    cout << "MPMC Queue tests passed\n";
+}
+
+void test_ws_deque() {
+    cout << "Testing Work-Stealing Deque...\n";
+
+    static void *slots[64];
+    ws_deque_t dq;
+    assert(wsd_init(&dq, slots, 48) == false);  // Not a power of two
+    assert(wsd_init(&dq, slots, 4) == true);
+
+    // Owner end is LIFO, steal end is FIFO
+    void *task;
+    assert(wsd_pop(&dq, &task) == false && wsd_steal(&dq, &task) == false);
+    for (uintptr_t i = 1; i <= 4; i++) {
+        assert(wsd_push(&dq, (void *)i) == true);
+    }
+    assert(wsd_push(&dq, (void *)5) == false);  // Full
+    assert(wsd_size_approx(&dq) == 4);
+    assert(wsd_pop(&dq, &task) == true && task == (void *)4);
+    assert(wsd_steal(&dq, &task) == true && task == (void *)1);
+    assert(wsd_push(&dq, (void *)5) == true && wsd_push(&dq, (void *)6) == true);  // Wraps
+    assert(wsd_steal(&dq, &task) == true && task == (void *)2);
+    assert(wsd_pop(&dq, &task) == true && task == (void *)6);
+    assert(wsd_pop(&dq, &task) == true && task == (void *)5);
+    assert(wsd_pop(&dq, &task) == true && task == (void *)3);
+    assert(wsd_pop(&dq, &task) == false && wsd_size_approx(&dq) == 0);
+
+    // Stress: the owner pushes and pops (often down to the last task, where it races the
+    // thieves), three thieves steal. Every task must be taken exactly once.
+    assert(wsd_init(&dq, slots, 64) == true);
+    const uintptr_t tasks = 200000;
+    vector<uint8_t> seen(tasks + 1, 0);
+    bool done = false;
+    size_t stolen[3] = {0, 0, 0};
+    vector<thread> thieves;
+    for (int k = 0; k < 3; k++) {
+        thieves.emplace_back([&dq, &seen, &done, &stolen, k]() {
+            void *got;
+            for (;;) {
+                if (wsd_steal(&dq, &got)) {
+                    __atomic_fetch_add(&seen[(uintptr_t)got], 1, __ATOMIC_RELAXED);
+                    stolen[k]++;
+                } else if (__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+                    break;
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    uint32_t state = 12345;
+    for (uintptr_t i = 1; i <= tasks; i++) {
+        if (!wsd_push(&dq, (void *)i)) {
+            seen[i]++;  // Full: the owner runs the task itself
+        }
+        state = state * 1664525u + 1013904223u;
+        for (uint32_t pops = state >> 30; pops > 0 && wsd_pop(&dq, &task); pops--) {
+            __atomic_fetch_add(&seen[(uintptr_t)task], 1, __ATOMIC_RELAXED);
+        }
+        if (i % 256 == 0) {
+            this_thread::yield();  // Lets the thieves in even on a single core
+        }
+    }
+    while (wsd_pop(&dq, &task)) {
+        __atomic_fetch_add(&seen[(uintptr_t)task], 1, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    for (auto &t : thieves) {
+        t.join();
+    }
+    for (uintptr_t i = 1; i <= tasks; i++) {
+        assert(seen[i] == 1);
+    }
+    assert(wsd_size_approx(&dq) == 0);
+    assert(stolen[0] + stolen[1] + stolen[2] > 0);
+
+    cout << "Work-Stealing Deque tests passed\n";
+}
+#ifdef __linux__
+void test_shm_ring() {
+    cout << "Testing Shared-Memory Ring...\n";
+
+    int fd = memfd_create("test_shm_ring", 0);
+    assert(fd >= 0);
+    shm_ring_t producer;
+    shm_ring_t consumer;
+    assert(shm_ring_attach(&consumer, fd) == false);  // Nothing created yet
+    assert(shm_ring_create(&producer, fd, 1000) == true);
+
+    // A second mapping of the same segment lands at a different address but sees the
+    // same ring, because the header stores offsets rather than pointers
+    assert(shm_ring_attach(&consumer, fd) == true);
+    assert(consumer.header != producer.header);
+    uint8_t in[600];
+    uint8_t out[600];
+    for (int i = 0; i < 600; i++) {
+        in[i] = (uint8_t)(i * 7);
+    }
+    assert(shm_ring_write_n(&producer, in, 600) == 600);
+    assert(shm_ring_read_n(&consumer, out, 600) == 600 && memcmp(in, out, 600) == 0);
+    assert(shm_ring_write_n(&producer, in, 600) == 600);  // Wraps
+    cb_region_t regions[2];
+    assert(shm_ring_read_peek(&consumer, regions) == 600);
+    assert(regions[0].len == 400 && regions[1].len == 200 && regions[1].data[0] == in[400]);
+    assert(shm_ring_read_consume(&consumer, 600) == true);
+    shm_ring_detach(&consumer);
+
+    // Separate process as producer, streaming far more than the ring holds
+    const size_t total = 1 << 20;
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        shm_ring_t child;
+        if (!shm_ring_attach(&child, fd)) {
+            _exit(1);
+        }
+        uint8_t chunk[333];
+        for (size_t sent = 0; sent < total; ) {
+            size_t n = (total - sent < sizeof(chunk)) ? total - sent : sizeof(chunk);
+            for (size_t k = 0; k < n; k++) {
+                chunk[k] = (uint8_t)((sent + k) % 251);
+            }
+            size_t written = shm_ring_write_n(&child, chunk, n);
+            sent += written;
+            if (written == 0) {
+                sched_yield();
+            }
+        }
+        _exit(0);
+    }
+    // Parent is now the consumer, through the mapping it created the ring with
+    for (size_t received = 0; received < total; ) {
+        size_t n = shm_ring_read_n(&producer, out, sizeof(out));
+        for (size_t k = 0; k < n; k++) {
+            assert(out[k] == (uint8_t)((received + k) % 251));
+        }
+        received += n;
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+    int status;
+    assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    shm_ring_detach(&producer);
+
+    // Re-creating over an existing segment starts a fresh, empty ring
+    assert(shm_ring_create(&producer, fd, 500) == true);
+    assert(shm_ring_attach(&consumer, fd) == true);
+    assert(consumer.header->size == 500 && shm_ring_read_n(&consumer, out, sizeof(out)) == 0);
+    shm_ring_detach(&consumer);
+    shm_ring_detach(&producer);
+    close(fd);
+    cout << "Shared-Memory Ring tests passed\n";
+}
+#endif
+void test_record_ring() {
+    cout << "Testing Record Ring...\n";
+
+    alignas(4) uint8_t storage[64];
+    record_ring_t rr;
+    rr_init(&rr, storage, sizeof(storage));
+    assert(rr_is_empty(&rr) == true);
+
+    // Whole messages in, whole messages out - FIFO and in place
+    assert(rr_append(&rr, "hello", 5) == true);       // 4 + 5 -> 12 bytes
+    assert(rr_append(&rr, "sensor data", 11) == true);  // 4 + 11 -> 16 bytes
+    assert(rr_record_count(&rr) == 2);
+    size_t len;
+    const uint8_t *msg = rr_peek(&rr, &len);
+    assert(msg != NULL && len == 5 && memcmp(msg, "hello", 5) == 0);
+    assert(msg >= storage && msg < storage + sizeof(storage));  // Zero-copy
+    assert(rr_consume(&rr) == true);
+
+    // Reserve/commit straight into the ring, committing less than reserved
+    uint8_t *slot = rr_reserve(&rr, 20);  // 24 bytes at offset 28
+    assert(slot != NULL);
+    memcpy(slot, "abc", 3);
+    assert(rr_commit(&rr, 3) == true);
+    assert(rr_commit(&rr, 3) == false);  // No reservation open
+
+    // 36 bytes free at the end, 12 at the start: a 28-byte record cannot be split,
+    // so it waits even though 48 bytes are free in total
+    uint8_t big[40];
+    memset(big, 0xEE, sizeof(big));
+    assert(rr_append(&rr, big, 40) == false);     // 44 bytes: no contiguous block
+    assert(rr_append(&rr, big, 24) == true);      // 28 bytes: fits before the end
+    assert(rr_append(&rr, big, 6) == true);       // 12 bytes: wraps to offset 0
+    msg = rr_peek(&rr, &len);
+    assert(len == 11 && memcmp(msg, "sensor data", 11) == 0);
+    assert(rr_consume(&rr) == true);
+    msg = rr_peek(&rr, &len);
+    assert(len == 3 && memcmp(msg, "abc", 3) == 0);
+    assert(rr_consume(&rr) == true);
+    msg = rr_peek(&rr, &len);
+    assert(len == 24 && msg[23] == 0xEE);
+    assert(rr_consume(&rr) == true);
+    msg = rr_peek(&rr, &len);
+    assert(len == 6 && msg == storage + RR_HEADER_SIZE);  // The record after the wrap
+    assert(rr_consume(&rr) == true);
+    assert(rr_is_empty(&rr) == true && rr_consume(&rr) == false);
+
+    // A reservation that wrapped skips the end of the ring. If the consumer then empties
+    // the ring before the commit, that skipped space is released too: a bigger
+    // reservation made instead gets the whole ring, not just the space before the skip
+    rr_init(&rr, storage, sizeof(storage));
+    assert(rr_append(&rr, big, 36) == true);   // 40 bytes at offset 0
+    assert(rr_append(&rr, big, 8) == true);    // 12 bytes at offset 40
+    assert(rr_consume(&rr) == true);
+    assert(rr_reserve(&rr, 24) == storage + RR_HEADER_SIZE);  // 12 left at the end: wraps
+    assert(rr_consume(&rr) == true && rr_is_empty(&rr) == true);
+    slot = rr_reserve(&rr, 52);                // 56 bytes of 64
+    assert(slot == storage + RR_HEADER_SIZE);
+    memset(slot, 0x5A, 52);
+    assert(rr_commit(&rr, 52) == true);
+    msg = rr_peek(&rr, &len);
+    assert(msg == slot && len == 52 && msg[51] == 0x5A);
+    assert(rr_consume(&rr) == true && rr_is_empty(&rr) == true);
+
+    // Many cycles with varying sizes, so wraps land in different places
+    uint8_t payload[30];
+    size_t next_in = 0;
+    size_t next_out = 0;
+    for (int i = 0; i < 1000; i++) {
+        size_t n = (next_in * 7) % 30;
+        memset(payload, (int)(next_in & 0xFF), n);
+        if (rr_append(&rr, payload, n)) {
+            next_in++;
+        }
+        if (i % 3 != 0) {
+            msg = rr_peek(&rr, &len);
+            if (msg != NULL) {
+                assert(len == (next_out * 7) % 30);
+                assert(len == 0 || msg[len - 1] == (uint8_t)(next_out & 0xFF));
+                rr_consume(&rr);
+                next_out++;
+            }
+        }
+    }
+    assert(next_in > 600 && next_in - next_out == rr_record_count(&rr));
+
+    cout << "Record Ring tests passed\n";
+}
+
+void test_lane_ring() {
+    cout << "Testing Lane Ring...\n";
+
+    uint32_t block[256];  // 1 KB, 4-byte aligned
+    lane_ring_t lr;
+    size_t sizes[3] = {128, 768, 128};
+    assert(lr_init(&lr, (uint8_t *)block, sizeof(block), sizes, 3) == true);
+    size_t too_big[2] = {768, 512};
+    lane_ring_t bad;
+    assert(lr_init(&bad, (uint8_t *)block, sizeof(block), too_big, 2) == false);
+    assert(lr_init(&bad, (uint8_t *)block, sizeof(block), NULL, LR_MAX_LANES + 1) == false);
+
+    size_t lane = 0, len = 0;
+    assert(lr_is_empty(&lr) == true && lr_peek(&lr, &lane, &len) == NULL);
+
+    // Strict priority: a control message overtakes the bulk data queued before it
+    char bulk[16] = "bulk-data";
+    int pushed = 0;
+    while (lr_push(&lr, 1, bulk, sizeof(bulk))) {
+        pushed++;  // Flood lane 1 until it is full
+    }
+    assert(pushed > 10 && lr_lane_count(&lr, 1) == (size_t)pushed);
+    assert(lr_push(&lr, 0, "stop", 4) == true);
+    const uint8_t *msg = lr_peek(&lr, &lane, &len);
+    assert(lane == 0 && len == 4 && memcmp(msg, "stop", 4) == 0);
+    assert(lr_consume(&lr, lane) == true);
+    msg = lr_peek(&lr, &lane, &len);
+    assert(lane == 1 && len == sizeof(bulk));
+    assert(lr_push(&lr, 5, "x", 1) == false);  // No such lane
+
+    // Weighted round-robin 3:1 between lanes 0 and 1, lane 2 joins later
+    while (lr_peek(&lr, &lane, &len) != NULL) {
+        lr_consume(&lr, lane);
+    }
+    lr_set_policy(&lr, LR_WEIGHTED);
+    assert(lr_set_weight(&lr, 0, 3) == true && lr_set_weight(&lr, 1, 0) == false);
+    for (int i = 0; i < 6; i++) {
+        assert(lr_push(&lr, 0, "c", 1) == true);
+        assert(lr_push(&lr, 1, "d", 1) == true);
+    }
+    string order;
+    for (int i = 0; i < 8; i++) {
+        lr_peek(&lr, &lane, &len);
+        order += (char)('0' + lane);
+        lr_consume(&lr, lane);
+    }
+    assert(order == "00010001");
+    assert(lr_push(&lr, 2, "e", 1) == true);
+    order.clear();
+    while (lr_peek(&lr, &lane, &len) != NULL) {
+        order += (char)('0' + lane);
+        lr_consume(&lr, lane);
+    }
+    assert(order == "21111");  // Lane 0 is empty now: lane 1's turn was over, so 2 goes next
+    assert(lr_is_empty(&lr) == true);
+
+    cout << "Lane Ring tests passed\n";
+}
+
+void test_compressed_ring() {
+    cout << "Testing Compressed Ring...\n";
+
+    // Codec round trips, from constant blocks (0 bits) to full-range noise (32 bits)
+    int32_t block[CR_BLOCK], decoded[CR_BLOCK];
+    uint8_t encoded[CR_MAX_ENCODED];
+    uint32_t state = 777;
+    for (unsigned spread = 0; spread <= 32; spread++) {
+        for (int i = 0; i < CR_BLOCK; i++) {
+            state = state * 1664525u + 1013904223u;
+            uint32_t noise = spread == 0 ? 0 : (spread == 32 ? state : state & ((1u << spread) - 1));
+            block[i] = (int32_t)(1000000u + noise);
+        }
+        size_t len = cr_encode_block(block, encoded);
+        assert(len <= CR_MAX_ENCODED);
+        cr_decode_block(encoded, decoded);
+        assert(memcmp(block, decoded, sizeof(block)) == 0);
+    }
+    for (int i = 0; i < CR_BLOCK; i++) {
+        block[i] = (i & 1) ? 0 : INT32_MIN;  // Deltas of +-2^31 wrap around: 32 bits each
+    }
+    assert(cr_encode_block(block, encoded) == CR_MAX_ENCODED);
+    cr_decode_block(encoded, decoded);
+    assert(memcmp(block, decoded, sizeof(block)) == 0);
+    for (int i = 0; i < CR_BLOCK; i++) {
+        block[i] = 42;
+    }
+    assert(cr_encode_block(block, encoded) == CR_BLOCK_HEADER);  // Constant: header only
+
+    // Ring of slowly changing telemetry: a 4 KB buffer holds far more than 1024 values
+    uint32_t memory[1024];
+    compressed_ring_t cr;
+    assert(cr_init(&cr, (uint8_t *)memory, 256) == false);  // Too small for a worst-case block
+    assert(cr_init(&cr, (uint8_t *)memory, sizeof(memory)) == true);
+    assert(cr_compression_ratio(&cr) == 1.0);
+    int32_t value = 20000;
+    vector<int32_t> pushed;
+    for (int i = 0; i < 20000; i++) {
+        state = state * 1664525u + 1013904223u;
+        value += (int32_t)(state >> 29) - 3;  // Random walk, steps -3..+4
+        pushed.push_back(value);
+        cr_push(&cr, value);
+    }
+    assert(cr_dropped_count(&cr) > 0 && cr_dropped_count(&cr) % CR_BLOCK == 0);
+    assert(cr_size(&cr) + cr_dropped_count(&cr) == pushed.size());
+    assert(cr_size(&cr) > 6 * 1024);  // Held in 4 KB
+    assert(cr_compression_ratio(&cr) > 6.0);
+
+    // Oldest surviving value first, all the way to the newest (in the staging block)
+    size_t next = cr_dropped_count(&cr);
+    int32_t out[300];
+    size_t n;
+    while ((n = cr_pop_n(&cr, out, 300)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            assert(out[i] == pushed[next + i]);
+        }
+        next += n;
+    }
+    assert(next == pushed.size() && cr_size(&cr) == 0);
+
+    // Reader keeps pace with the writer inside the staging block
+    int32_t got;
+    for (int32_t i = 0; i < 1000; i++) {
+        cr_push(&cr, i * 3);
+        if (i % 3 == 2) {
+            for (int32_t k = i - 2; k <= i; k++) {
+                assert(cr_pop(&cr, &got) == true && got == k * 3);
+            }
+        }
+    }
+    assert(cr_pop(&cr, &got) == true && got == 999 * 3);
+    assert(cr_pop(&cr, &got) == false);
+
+    cout << "Compressed Ring tests passed\n";
+}
+void test_timeseries_ring() {
+    cout << "Testing Time-Series Ring...\n";
+
+    typedef struct { float reading; uint32_t sensor; } sample_t;
+    uint64_t times[100];
+    sample_t values[100];
+    ts_ring_t ts;
+    ts_span_t spans[2];
+    assert(ts_init(&ts, times, values, sizeof(sample_t), 0) == false);
+    assert(ts_init(&ts, times, values, sizeof(sample_t), 100) == true);
+    assert(ts_range(&ts, 0, UINT64_MAX, spans) == 0);
+    assert(ts_lower_bound(&ts, 5) == 0);
+
+    // 250 samples, two per timestamp (t = 10, 10, 20, 20, ...): the ring keeps the last 100
+    for (uint32_t i = 0; i < 250; i++) {
+        sample_t s = { (float)i * 0.5f, i };
+        assert(ts_append(&ts, 10 + (i / 2) * 10, &s) == true);
+    }
+    sample_t late = { 0.0f, 999 };
+    assert(ts_append(&ts, 1200, &late) == false);  // Older than the newest sample
+    assert(ts_size(&ts) == 100 && ts_dropped_count(&ts) == 150);
+    uint64_t t;
+    const sample_t *oldest = (const sample_t *)ts_at(&ts, 0, &t);
+    assert(oldest->sensor == 150 && t == 760);
+    assert(ts_at(&ts, 100, &t) == NULL);
+
+    // Every range against a linear scan, across the wrap point and past both ends
+    for (uint64_t t0 = 700; t0 <= 1300; t0 += 5) {
+        for (uint64_t t1 = t0 - 20; t1 <= t0 + 300; t1 += 15) {
+            size_t expected_first = 0, expected_count = 0;
+            for (size_t i = 0; i < 100; i++) {
+                ts_at(&ts, i, &t);
+                if (t < t0) {
+                    expected_first = i + 1;
+                } else if (t <= t1) {
+                    expected_count++;
+                }
+            }
+            size_t used = ts_range(&ts, t0, t1, spans);
+            assert(used == (spans[1].count > 0 ? 2u : (spans[0].count > 0 ? 1u : 0u)));
+            assert(spans[0].count + spans[1].count == expected_count);
+            size_t k = expected_first;
+            for (size_t s = 0; s < used; s++) {
+                for (size_t j = 0; j < spans[s].count; j++, k++) {
+                    const sample_t *v = (const sample_t *)(spans[s].values + j * sizeof(sample_t));
+                    assert(spans[s].timestamps[j] >= t0 && spans[s].timestamps[j] <= t1);
+                    assert(v->sensor == 150 + k && v->reading == (float)(150 + k) * 0.5f);
+                }
+            }
+        }
+    }
+    // Whole ring: two spans meeting at the end of the arrays, zero-copy
+    assert(ts_range(&ts, 0, UINT64_MAX, spans) == 2);
+    assert(spans[0].timestamps == times + 50 && spans[0].count == 50);
+    assert(spans[1].timestamps == times && spans[1].count == 50);
+    assert((const void *)spans[1].values == (const void *)values);
+
+    // Retention: forget everything before t = 1000
+    assert(ts_drop_before(&ts, 1000) == 48);
+    assert(ts_lower_bound(&ts, 1000) == 0 && ts_size(&ts) == 52);
+    ts_at(&ts, 0, &t);
+    assert(t == 1000);
+    sample_t next = { 1.0f, 250 };
+    assert(ts_append(&ts, 1260, &next) == true && ts_size(&ts) == 53);
+    assert(ts_range(&ts, 1255, 1300, spans) == 1 && spans[0].count == 1);
+    assert(ts_drop_before(&ts, 5000) == 53 && ts_is_empty(&ts));
+
+    cout << "Time-Series Ring tests passed\n";
+}
+
+void test_broadcast_ring() {
+    cout << "Testing Broadcast Ring...\n";
+
+    uint32_t memory[4];
+    bc_reader_t readers[2];
+    broadcast_ring_t bc;
+    assert(bc_init(&bc, (uint8_t *)memory, 3, sizeof(uint32_t), readers, 2) == false);
+    assert(bc_init(&bc, (uint8_t *)memory, 4, sizeof(uint32_t), readers, 2) == true);
+
+    // Written once, read by both readers from the same slot
+    uint32_t event = 10;
+    assert(bc_write(&bc, &event) == true);
+    const uint32_t *seen0 = (const uint32_t *)bc_peek(&bc, 0);
+    const uint32_t *seen1 = (const uint32_t *)bc_peek(&bc, 1);
+    assert(seen0 == seen1 && *seen0 == 10);
+    assert(bc_advance(&bc, 0, 2) == false);  // Only one event published
+    assert(bc_advance(&bc, 0, 1) == true);
+    assert(bc_peek(&bc, 0) == NULL && bc_available(&bc, 1) == 1);
+
+    // The writer is gated by the slowest reader (reader 1 has not moved)
+    for (event = 11; event < 14; event++) {
+        assert(bc_write(&bc, &event) == true);
+    }
+    assert(bc_write(&bc, &event) == false);
+    uint32_t out;
+    assert(bc_read(&bc, 1, &out) == true && out == 10);
+    uint32_t *slot = (uint32_t *)bc_claim(&bc);  // Zero-copy write into the freed slot
+    assert(slot != NULL);
+    *slot = 14;
+    bc_publish(&bc);
+    for (uint32_t expected = 11; expected <= 14; expected++) {
+        assert(bc_read(&bc, 0, &out) == true && out == expected);
+        assert(bc_read(&bc, 1, &out) == true && out == expected);
+    }
+
+    // Three reader threads each receive every event, in order
+    uint32_t storage[64];
+    bc_reader_t thread_readers[3];
+    assert(bc_init(&bc, (uint8_t *)storage, 64, sizeof(uint32_t), thread_readers, 3) == true);
+    const uint32_t total = 100000;
+    vector<thread> subscribers;
+    for (size_t r = 0; r < 3; r++) {
+        subscribers.emplace_back([&bc, r, total]() {
+            uint32_t value;
+            for (uint32_t expected = 0; expected < total; ) {
+                if (bc_read(&bc, r, &value)) {
+                    assert(value == expected);
+                    expected++;
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (uint32_t i = 0; i < total; ) {
+        if (bc_write(&bc, &i)) {
+            i++;
+        } else {
+            this_thread::yield();
+        }
+    }
+    for (auto &t : subscribers) {
+        t.join();
+    }
+
+    cout << "Broadcast Ring tests passed\n";
+}
+#ifdef __linux__
+
+// Snapshot written by the latest-value tests - every field derives from seq, so a torn
+// copy is easy to spot
+typedef struct {
+    uint64_t seq;
+    uint64_t twice;
+    uint64_t inverted;
+    uint8_t tail[13];  // Odd size: the seqlock copies a partial last word
+} lv_sample_t;
+
+static lv_sample_t lv_make_sample(uint64_t seq) {
+    lv_sample_t s;
+    s.seq = seq;
+    s.twice = seq * 2;
+    s.inverted = ~seq;
+    memset(s.tail, (int)(seq & 0xFF), sizeof(s.tail));
+    return s;
+}
+
+static bool lv_sample_ok(const lv_sample_t &s) {
+    for (size_t i = 0; i < sizeof(s.tail); i++) {
+        if (s.tail[i] != (uint8_t)(s.seq & 0xFF)) return false;
+    }
+    return s.twice == s.seq * 2 && s.inverted == ~s.seq;
+}
+
+void test_latest_value() {
+    cout << "Testing Latest Value slots...\n";
+
+    // Seqlock slot
+    uint64_t storage[LV_STORAGE_SIZE(sizeof(lv_sample_t)) / 8];
+    lv_slot_t slot;
+    lv_init(&slot, storage, sizeof(lv_sample_t));
+    lv_sample_t out;
+    assert(lv_read(&slot, &out) == false && lv_version(&slot) == 0);
+    lv_sample_t first = lv_make_sample(1);
+    lv_publish(&slot, &first);
+    lv_sample_t second = lv_make_sample(2);
+    lv_publish(&slot, &second);
+    assert(lv_read(&slot, &out) == true && out.seq == 2 && lv_sample_ok(out));  // Only the newest
+    assert(lv_version(&slot) == 2);
+
+    // Triple buffer
+    uint8_t memory[3 * sizeof(lv_sample_t)];
+    triple_buffer_t tb;
+    tb_init(&tb, memory, sizeof(lv_sample_t));
+    bool fresh = true;
+    assert(tb_read_latest(&tb, &fresh) == NULL && fresh == false);
+    for (uint64_t seq = 1; seq <= 3; seq++) {
+        *(lv_sample_t *)tb_write_buffer(&tb) = lv_make_sample(seq);
+        tb_publish(&tb);
+    }
+    const lv_sample_t *latest = (const lv_sample_t *)tb_read_latest(&tb, &fresh);
+    assert(latest != NULL && fresh == true && latest->seq == 3);
+    latest = (const lv_sample_t *)tb_read_latest(&tb, &fresh);
+    assert(latest->seq == 3 && fresh == false);  // Same value again, not fresh
+    *(lv_sample_t *)tb_write_buffer(&tb) = lv_make_sample(4);
+    assert(((const lv_sample_t *)tb_read_latest(&tb, NULL))->seq == 3);  // Not published yet
+    tb_publish(&tb);
+    assert(((const lv_sample_t *)tb_read_latest(&tb, NULL))->seq == 4);
+
+    // Concurrent: one writer, readers only ever see whole snapshots that never go back
+    const uint64_t total = 200000;
+    lv_init(&slot, storage, sizeof(lv_sample_t));
+    tb_init(&tb, memory, sizeof(lv_sample_t));
+    bool done = false;
+    thread writer([&]() {
+        for (uint64_t seq = 1; seq <= total; seq++) {
+            lv_sample_t s = lv_make_sample(seq);
+            lv_publish(&slot, &s);
+            *(lv_sample_t *)tb_write_buffer(&tb) = s;
+            tb_publish(&tb);
+        }
+        __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+    });
+    thread seq_reader([&]() {
+        uint64_t last = 0;
+        lv_sample_t s;
+        while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE) || last < total) {
+            if (lv_read(&slot, &s)) {
+                assert(lv_sample_ok(s) && s.seq >= last);
+                last = s.seq;
+            }
+        }
+    });
+    uint64_t last = 0;
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE) || last < total) {
+        const lv_sample_t *s = (const lv_sample_t *)tb_read_latest(&tb, NULL);
+        if (s != NULL) {
+            assert(lv_sample_ok(*s) && s->seq >= last);
+            last = s->seq;
+        }
+    }
+    writer.join();
+    seq_reader.join();
+
+    cout << "Latest Value tests passed\n";
+}
+
+#ifdef __linux__
+// Payload of record seq in the ring log tests: length and bytes derive from seq
+static size_t rl_test_len(uint64_t seq) { return (size_t)(seq * 37 % 90); }
+static uint8_t rl_test_byte(uint64_t seq, size_t i) { return (uint8_t)(seq * 131 + i); }
+
+static void rl_test_append(ring_log_t *log, uint64_t seq) {
+    uint8_t payload[128];
+    for (size_t i = 0; i < rl_test_len(seq); i++) payload[i] = rl_test_byte(seq, i);
+    assert(rl_append(log, payload, rl_test_len(seq)) == true);
+}
+
+// Sequence numbers of the records, oldest first (every one intact, numbers increasing)
+static vector<uint64_t> rl_test_records(ring_log_t *log) {
+    vector<uint64_t> seqs;
+    rl_iter_t it;
+    rl_iter_init(log, &it);
+    size_t len;
+    uint64_t seq;
+    while (const uint8_t *payload = rl_iter_next(log, &it, &len, &seq)) {
+        assert(seqs.empty() || seq > seqs.back());  // Gaps only where a crash lost records
+        assert(len == rl_test_len(seq));
+        for (size_t i = 0; i < len; i++) assert(payload[i] == rl_test_byte(seq, i));
+        seqs.push_back(seq);
+    }
+    assert(seqs.size() == rl_record_count(log));
+    return seqs;
+}
+
+// As above, and the newest record is last_seq
+static size_t rl_test_check(ring_log_t *log, uint64_t last_seq) {
+    vector<uint64_t> seqs = rl_test_records(log);
+    assert(seqs.empty() ? last_seq == 0 : seqs.back() == last_seq);
+    return seqs.size();
+}
+
+// Every number in subset also appears in seqs (both increasing)
+static bool rl_test_contains(const vector<uint64_t> &seqs, const vector<uint64_t> &subset) {
+    size_t i = 0;
+    for (uint64_t seq : subset) {
+        while (i < seqs.size() && seqs[i] < seq) i++;
+        if (i == seqs.size() || seqs[i] != seq) return false;
+    }
+    return true;
+}
+
+void test_ring_log() {
+    cout << "Testing Ring Log...\n";
+
+    assert(rl_crc32c(0, "123456789", 9) == 0xE3069283u);  // CRC32C check value
+
+    char path[] = "/tmp/ring_log_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    unlink(path);
+
+    ring_log_t log;
+    assert(rl_open(&log, fd, 1024) == true);
+    assert(rl_record_count(&log) == 0 && log.size == 1024);
+    for (uint64_t seq = 1; seq <= 5; seq++) rl_test_append(&log, seq);
+    assert(rl_test_check(&log, 5) == 5);
+    rl_close(&log);
+
+    // Reopen: head/tail come back from the file
+    assert(rl_open(&log, fd, 0) == true);
+    assert(rl_test_check(&log, 5) == 5);
+    assert(log.next_seq == 6);
+
+    // Keep appending well past several wraps; after every append a second handle opened
+    // on the same file (as a restarted process would) must agree on the newest record
+    for (uint64_t seq = 6; seq <= 400; seq++) {
+        rl_test_append(&log, seq);
+        size_t live = rl_test_check(&log, seq);
+        ring_log_t crashed;
+        assert(rl_open(&crashed, fd, 0) == true);
+        assert(rl_test_check(&crashed, seq) >= live);  // Dropped-but-intact records may come back
+        assert(crashed.next_seq == seq + 1);
+        rl_close(&crashed);
+    }
+    assert(rl_record_count(&log) > 5);
+
+    // Crash in the middle of an append: reserved and partly written, never committed
+    uint8_t *partial = rl_reserve(&log, rl_test_len(401));
+    assert(partial != NULL);
+    for (size_t i = 0; i < rl_test_len(401) / 2; i++) partial[i] = rl_test_byte(401, i);
+    ring_log_t crashed;
+    assert(rl_open(&crashed, fd, 0) == true);
+    rl_test_check(&crashed, 400);
+    rl_close(&crashed);
+    for (size_t i = rl_test_len(401) / 2; i < rl_test_len(401); i++) partial[i] = rl_test_byte(401, i);
+    assert(rl_commit(&log, rl_test_len(401)) == true);
+    rl_test_check(&log, 401);
+    assert(rl_commit(&log, 0) == false);  // Reservation already committed
+    for (uint64_t seq = 402; seq <= 410; seq++) rl_test_append(&log, seq);
+    assert(rl_commit(&log, 0) == false);  // None open: nothing was evicted to make room
+    rl_test_check(&log, 410);
+
+    // Torn newest record: its payload does not match the checksum any more
+    rl_test_append(&log, 411);
+    uint8_t *torn = log.data + (log.head == 0 ? log.size : log.head) - 8;
+    *torn ^= 0xFF;
+    assert(rl_open(&crashed, fd, 0) == true);
+    rl_test_check(&crashed, 410);
+    rl_close(&crashed);
+    rl_close(&log);
+
+    // Crash inside a reservation that evicted (and partly overwrote) every record: the
+    // reopened log may be empty, but sequence numbers carry on from where they were
+    assert(rl_open(&log, fd, 0) == true);
+    uint64_t issued = log.next_seq - 1;
+    uint8_t *huge = rl_reserve(&log, 960);
+    assert(huge != NULL && rl_record_count(&log) == 0);
+    memset(huge, 0xA5, 960);
+    rl_close(&log);
+    assert(rl_open(&log, fd, 0) == true);
+    assert(log.next_seq == issued + 1);
+    rl_test_append(&log, issued + 1);
+    rl_close(&log);
+    assert(rl_open(&log, fd, 0) == true);
+    assert(rl_test_check(&log, issued + 1) >= 1 && log.next_seq == issued + 2);
+    rl_close(&log);
+
+    // A crash tears the newest record (s5) while an older one (s4) survives: s6, written
+    // after the reopen, must still chain onto s4 across the lost number and survive the
+    // next (clean) reopen
+    assert(ftruncate(fd, 0) == 0);
+    assert(rl_open(&log, fd, 144) == true);
+    uint8_t bytes[56] = {0};
+    const size_t lens[5] = {56, 0, 0, 0, 0};
+    for (size_t i = 0; i < 5; i++) assert(rl_append(&log, bytes, lens[i]) == true);
+    uint8_t *tear = rl_reserve(&log, 120);
+    assert(tear != NULL);
+    memset(tear, 0xA5, 3);
+    rl_close(&log);
+    assert(rl_open(&log, fd, 0) == true);
+    assert(log.next_seq == 6);
+    assert(rl_append(&log, bytes, 0) == true);
+    for (int reopen = 0; reopen < 2; reopen++) {
+        rl_iter_t it;
+        rl_iter_init(&log, &it);
+        size_t len;
+        uint64_t seq;
+        vector<uint64_t> seqs;
+        while (rl_iter_next(&log, &it, &len, &seq) != NULL) seqs.push_back(seq);
+        assert((seqs == vector<uint64_t>{2, 3, 4, 6}));
+        rl_close(&log);
+        assert(rl_open(&log, fd, 0) == true);
+    }
+    rl_close(&log);
+
+    // Random appends, closes and crashes inside a reservation (reserved, partly written,
+    // never committed - some span the whole area), each followed by a reopen. Only records
+    // the reservation evicted may be lost and sequence numbers never go backwards. Then
+    // one more append and a clean reopen, which must return exactly the live records.
+    assert(ftruncate(fd, 0) == 0);
+    assert(rl_open(&log, fd, 1024) == true);
+    uint32_t state = 2024;
+    uint64_t last = 0;
+    for (int round = 0; round < 3000; round++) {
+        state = state * 1664525u + 1013904223u;
+        int appends = (int)(state >> 28);
+        for (int i = 0; i < appends; i++) {
+            rl_test_append(&log, ++last);
+        }
+        state = state * 1664525u + 1013904223u;
+        bool crash = (state >> 31) != 0;
+        if (crash) {
+            size_t len = ((state >> 8) % 8 == 0) ? log.size - RL_HEADER_SIZE : (state >> 12) % 200;
+            uint8_t *slot = rl_reserve(&log, len);
+            assert(slot != NULL);
+            memset(slot, 0xA5, (state >> 16) % (len + 1));
+        }
+        vector<uint64_t> live = rl_test_records(&log);
+        rl_close(&log);  // Crash: nothing else happens to the mapping
+        assert(rl_open(&log, fd, 0) == true);
+        vector<uint64_t> recovered = rl_test_records(&log);
+        assert(rl_test_contains(recovered, live));  // Dropped-but-intact records may come back
+        assert(crash || (!recovered.empty() ? recovered.back() == last : last == 0));
+        assert(log.next_seq == last + 1);
+
+        rl_test_append(&log, ++last);
+        live = rl_test_records(&log);
+        rl_close(&log);
+        assert(rl_open(&log, fd, 0) == true);
+        assert(rl_test_records(&log) == live && live.back() == last);
+        assert(log.next_seq == last + 1);
+    }
+    rl_close(&log);
+
+    // Empty record without a buffer, record larger than the whole log, and a file that is
+    // not a log
+    assert(rl_open(&log, fd, 0) == true);
+    assert(rl_append(&log, NULL, 0) == true);
+    uint8_t big[2048] = {0};
+    assert(rl_append(&log, big, sizeof(big)) == false);
+    rl_close(&log);
+    assert(ftruncate(fd, 0) == 0 && write(fd, big, 512) == 512);
+    assert(rl_open(&log, fd, 1024) == false);
+    close(fd);
+
+    cout << "Ring Log tests passed\n";
+}
+#endif
+void test_cb_io() {
+    cout << "Testing Circular Buffer fd I/O...\n";
+
+    int fds[2];
+    assert(pipe2(fds, O_NONBLOCK) == 0);
+    uint8_t storage[10];
+    circular_buffer_t cb;
+    cb_init(&cb, storage, 10);
+
+    // Nothing to read yet: EAGAIN, indices untouched
+    errno = 0;
+    assert(cb_fill_from_fd(&cb, fds[0]) == -1 && errno == EAGAIN);
+    assert(cb_is_empty(&cb) == true);
+
+    // Place head/tail near the end so both transfers need two iovecs
+    uint8_t scratch[8];
+    cb_write_n(&cb, scratch, 7);
+    cb_read_n(&cb, scratch, 7);
+    assert(write(fds[1], "0123456789ABC", 13) == 13);
+    assert(cb_fill_from_fd(&cb, fds[0]) == 10);  // One readv fills both regions
+    assert(cb_is_full(&cb) == true);
+    errno = 0;
+    assert(cb_fill_from_fd(&cb, fds[0]) == -1 && errno == ENOBUFS);
+
+    assert(cb_drain_to_fd(&cb, fds[1]) == 10);  // Back into the pipe with one writev
+    assert(cb_drain_to_fd(&cb, fds[1]) == 0);   // Nothing left to send
+    char text[14] = {0};
+    assert(read(fds[0], text, 13) == 13);
+    assert(memcmp(text, "ABC0123456789", 13) == 0);  // 3 bytes left over from the fill
+
+    // Partial fill: only what is in the pipe gets committed; EOF reads as 0
+    assert(write(fds[1], "xy", 2) == 2);
+    assert(cb_fill_from_fd(&cb, fds[0]) == 2 && cb_data_count(&cb) == 2);
+    close(fds[1]);
+    assert(cb_fill_from_fd(&cb, fds[0]) == 0);
+    close(fds[0]);
+
+    // Watermark crossings as eventfd signals
+    cb_watermark_fds_t wm = {eventfd(0, EFD_NONBLOCK), eventfd(0, EFD_NONBLOCK)};
+    assert(wm.high_fd >= 0 && wm.low_fd >= 0);
+    cb_init(&cb, storage, 10);
+    assert(cb_set_watermarks(&cb, 8, 2, cb_watermark_eventfd, &wm) == true);
+    uint8_t chunk[10] = {0};
+    eventfd_t signals = 0;
+    cb_write_n(&cb, chunk, 9);
+    assert(eventfd_read(wm.high_fd, &signals) == 0 && signals == 1);
+    assert(eventfd_read(wm.low_fd, &signals) == -1 && errno == EAGAIN);
+    cb_read_n(&cb, chunk, 8);
+    assert(eventfd_read(wm.low_fd, &signals) == 0 && signals == 1);
+    close(wm.high_fd);
+    close(wm.low_fd);
+
+    cout << "Circular Buffer fd I/O tests passed\n";
+}
+#endif
+#ifdef CB_URING_AVAILABLE
+// Pumps fd into a small buffer until end of file, draining it as it goes
+static string uring_drain_all(int fd, unsigned depth, size_t chunk) {
+    uint8_t storage[1000];
+    circular_buffer_t cb;
+    cb_init(&cb, storage, sizeof(storage));
+    cb_uring_t u;
+    assert(cb_uring_init(&u, &cb, fd, depth, chunk) == true);
+
+    string out;
+    uint8_t scratch[300];
+    while (!cb_uring_finished(&u) || !cb_is_empty(&cb)) {
+        assert(cb_uring_pump(&u, true) >= 0);
+        size_t n = cb_read_n(&cb, scratch, sizeof(scratch));  // Small reads keep the buffer wrapping
+        out.append((const char *)scratch, n);
+    }
+    assert(u.error == 0 && u.eof == true);
+    cb_uring_destroy(&u);
+    return out;
+}
+
+void test_cb_uring() {
+    cout << "Testing Circular Buffer io_uring pump...\n";
+
+    struct io_uring_params probe;
+    memset(&probe, 0, sizeof(probe));
+    int probe_fd = (int)syscall(__NR_io_uring_setup, 1, &probe);
+    if (probe_fd < 0) {
+        cout << "io_uring unavailable here - skipped\n";
+        return;
+    }
+    close(probe_fd);
+
+    string expected;
+    for (int i = 0; i < 20000; i++) {
+        expected += (char)('a' + (i * 7) % 26);
+    }
+
+    // Regular file: many reads in flight at explicit offsets, committed in order
+    char path[] = "/tmp/cb_uring_XXXXXX";
+    int file = mkstemp(path);
+    assert(file >= 0);
+    unlink(path);
+    assert(write(file, expected.data(), expected.size()) == (ssize_t)expected.size());
+    assert(lseek(file, 0, SEEK_SET) == 0);
+    assert(uring_drain_all(file, 8, 96) == expected);
+    close(file);
+
+    // Pipe: linked reads, the writer trickles data in uneven pieces
+    int fds[2];
+    assert(pipe(fds) == 0);
+    thread writer([&]() {
+        size_t sent = 0;
+        size_t piece = 1;
+        while (sent < expected.size()) {
+            size_t n = min(piece, expected.size() - sent);
+            assert(write(fds[1], expected.data() + sent, n) == (ssize_t)n);
+            sent += n;
+            piece = piece * 3 % 1021 + 1;
+        }
+        close(fds[1]);
+    });
+    assert(uring_drain_all(fds[0], 4, 128) == expected);
+    writer.join();
+
+    // Destroy with reads still parked on an empty pipe
+    int idle[2];
+    assert(pipe(idle) == 0);
+    uint8_t storage[64];
+    circular_buffer_t cb;
+    cb_init(&cb, storage, sizeof(storage));
+    cb_uring_t u;
+    assert(cb_uring_init(&u, &cb, idle[0], 4, 16) == true);
+    assert(cb_uring_pump(&u, false) == 0);
+    assert(u.inflight == 4);
+    cb_uring_destroy(&u);
+    close(idle[0]);
+    close(idle[1]);
+
+    cout << "Circular Buffer io_uring pump tests passed\n";
+}
+#endif
 void test_stack_allocator() {
     cout << "Testing Stack Allocator...\n";
 
@@ -104,6 +1707,35 @@ int main() {
     cout << "Testing Embedded Data Structures...\n\n";
 
     test_circular_buffer();  // Calling test functions
+#ifdef __linux__
+    test_cb_io();
+#endif
+#ifdef CB_URING_AVAILABLE
+    test_cb_uring();
+#endif
+    test_spsc_buffer();
+#ifdef __linux__
+    test_mirrored_buffer();
+#endif
+    test_ring();
+    test_window_ring();
+#ifdef RING_CHANNEL_AVAILABLE
+    test_ring_channel();
+#endif
+    test_mpmc_queue();
+    test_ws_deque();
+    test_record_ring();
+    test_lane_ring();
+    test_compressed_ring();
+    test_timeseries_ring();
+    test_broadcast_ring();
+    test_latest_value();
+#ifdef __linux__
+    test_ring_log();
+#endif
+#ifdef __linux__
+    test_shm_ring();
+#endif
     test_stack_allocator();
     test_memory_pool();
     test_hash_table();
@@ -0,0 +1,197 @@
+// Time-Series Ring = circular buffer of (timestamp, value) samples kept in time order.
+// Timestamps and values live in two separate caller-provided arrays (structure of
+// arrays): a range query only touches the uint64_t timestamp array, which stays dense
+// in cache however large the values are.
+// Because timestamps never go backwards, "all samples between t0 and t1" is two binary
+// searches - O(log n) instead of the O(n) scan a circular_buffer_t needs. The ring wraps,
+// so the samples are stored as (at most) two sorted runs; the search first picks the run
+// the boundary falls in and then bisects that contiguous run only.
+// Results come back as up to two spans pointing into the ring's own arrays (zero-copy).
+// They stay valid until the next append overwrites those slots.
+// When the ring is full, an append overwrites the oldest sample.
+// Not thread-safe on its own, like circular_buffer_t.
+#ifndef TIMESERIES_RING_H
+#define TIMESERIES_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+using namespace std;
+
+typedef struct {
+    uint64_t *timestamps;  // Caller-provided, capacity entries
+    uint8_t *values;       // Caller-provided, capacity * value_size bytes
+    size_t value_size;     // Bytes per value
+    size_t capacity;       // Maximum number of samples
+    size_t head;           // Slot of the next append
+    size_t count;          // Samples currently stored
+    size_t dropped;        // Samples overwritten since init
+} ts_ring_t;
+
+// One contiguous run of matching samples, pointing into the ring's arrays.
+// values[i * value_size] belongs to timestamps[i]; count is 0 when the run is unused.
+typedef struct {
+    const uint64_t *timestamps;
+    const uint8_t *values;
+    size_t count;
+} ts_span_t;
+
+// Function Declarations:
+// False if value_size or capacity is 0
+static inline bool ts_init(ts_ring_t *ts, uint64_t *timestamps, void *values, size_t value_size, size_t capacity);
+// Appends one sample. Timestamps must not decrease - false (nothing stored) if timestamp is
+// older than the newest sample. Equal timestamps are allowed.
+static inline bool ts_append(ts_ring_t *ts, uint64_t timestamp, const void *value);
+// Samples with t0 <= timestamp <= t1, oldest first, as up to two spans.
+// Returns the number of spans used (0 when nothing matches).
+static inline size_t ts_range(ts_ring_t *ts, uint64_t t0, uint64_t t1, ts_span_t spans[2]);
+// Index (0 = oldest) of the first sample with timestamp >= t; ts_size() if there is none
+static inline size_t ts_lower_bound(ts_ring_t *ts, uint64_t t);
+// i-th sample counting from the oldest (i < ts_size()); NULL if out of range
+static inline const uint8_t* ts_at(ts_ring_t *ts, size_t i, uint64_t *timestamp);
+// Forgets every sample older than t (retention), returns how many were removed
+static inline size_t ts_drop_before(ts_ring_t *ts, uint64_t t);
+
+static inline bool ts_is_empty(ts_ring_t *ts);
+static inline size_t ts_size(ts_ring_t *ts);
+static inline size_t ts_dropped_count(ts_ring_t *ts);
+
+// Helper Functions:
+// Slot of the oldest sample
+static inline size_t ts_tail(ts_ring_t *ts) {
+    return (ts->head >= ts->count) ? ts->head - ts->count : ts->head + ts->capacity - ts->count;
+}
+
+// Slot of the i-th sample counting from the oldest
+static inline size_t ts_slot(ts_ring_t *ts, size_t i) {
+    size_t slot = ts_tail(ts) + i;
+    return (slot >= ts->capacity) ? slot - ts->capacity : slot;
+}
+
+// First position in the sorted run a[0..n) with a[pos] >= t (n if none).
+// Branch-free bisection: the loop always runs log2(n) times and the compare becomes a
+// conditional move, so there are no mispredicted branches on random query times.
+static inline size_t ts_lower_bound_run(const uint64_t *a, size_t n, uint64_t t) {
+    if (n == 0) {
+        return 0;
+    }
+    const uint64_t *base = a;
+    while (n > 1) {
+        size_t half = n / 2;
+        base = (base[half] < t) ? base + half : base;
+        n -= half;
+    }
+    return (size_t)(base - a) + (*base < t);
+}
+
+// Splits the samples [first, last) (indices from the oldest) into contiguous spans
+static inline size_t ts_spans(ts_ring_t *ts, size_t first, size_t last, ts_span_t spans[2]) {
+    spans[0].count = 0;
+    spans[1].count = 0;
+    if (first >= last) {
+        return 0;
+    }
+    size_t start = ts_slot(ts, first);
+    size_t len = last - first;
+    size_t run = ts->capacity - start;  // Slots before the end of the arrays
+    spans[0].timestamps = ts->timestamps + start;
+    spans[0].values = ts->values + start * ts->value_size;
+    if (len <= run) {
+        spans[0].count = len;
+        return 1;
+    }
+    spans[0].count = run;
+    spans[1].timestamps = ts->timestamps;
+    spans[1].values = ts->values;
+    spans[1].count = len - run;
+    return 2;
+}
+
+// Function Implementations:
+static inline bool ts_init(ts_ring_t *ts, uint64_t *timestamps, void *values, size_t value_size, size_t capacity) {
+    if (value_size == 0 || capacity == 0) {
+        return false;
+    }
+    ts->timestamps = timestamps;
+    ts->values = (uint8_t *)values;
+    ts->value_size = value_size;
+    ts->capacity = capacity;
+    ts->head = 0;
+    ts->count = 0;
+    ts->dropped = 0;
+    return true;
+}
+
+static inline bool ts_append(ts_ring_t *ts, uint64_t timestamp, const void *value) {
+    if (ts->count > 0) {
+        size_t newest = (ts->head == 0) ? ts->capacity - 1 : ts->head - 1;
+        if (timestamp < ts->timestamps[newest]) {
+            return false;  // Would break the time order the searches rely on
+        }
+    }
+    ts->timestamps[ts->head] = timestamp;
+    memcpy(ts->values + ts->head * ts->value_size, value, ts->value_size);
+    ts->head = (ts->head + 1 == ts->capacity) ? 0 : ts->head + 1;
+    if (ts->count == ts->capacity) {
+        ts->dropped++;  // The oldest sample was just overwritten
+    } else {
+        ts->count++;
+    }
+    return true;
+}
+
+// The stored samples are the run [tail, capacity) followed by [0, head) when they wrap,
+// or the single run [tail, tail + count) otherwise. The last timestamp of the first run
+// tells which run holds the boundary.
+static inline size_t ts_lower_bound(ts_ring_t *ts, uint64_t t) {
+    size_t tail = ts_tail(ts);
+    size_t first_len = (tail + ts->count > ts->capacity) ? ts->capacity - tail : ts->count;
+    if (first_len == 0 || ts->timestamps[tail + first_len - 1] >= t) {
+        return ts_lower_bound_run(ts->timestamps + tail, first_len, t);
+    }
+    return first_len + ts_lower_bound_run(ts->timestamps, ts->count - first_len, t);
+}
+
+static inline size_t ts_range(ts_ring_t *ts, uint64_t t0, uint64_t t1, ts_span_t spans[2]) {
+    if (t0 > t1) {
+        spans[0].count = 0;
+        spans[1].count = 0;
+        return 0;
+    }
+    size_t first = ts_lower_bound(ts, t0);
+    // One past the last sample <= t1 is the first sample >= t1 + 1 (t1 = UINT64_MAX: all)
+    size_t last = (t1 == UINT64_MAX) ? ts->count : ts_lower_bound(ts, t1 + 1);
+    return ts_spans(ts, first, last, spans);
+}
+
+static inline const uint8_t* ts_at(ts_ring_t *ts, size_t i, uint64_t *timestamp) {
+    if (i >= ts->count) {
+        return NULL;
+    }
+    size_t slot = ts_slot(ts, i);
+    if (timestamp != NULL) {
+        *timestamp = ts->timestamps[slot];
+    }
+    return ts->values + slot * ts->value_size;
+}
+
+static inline size_t ts_drop_before(ts_ring_t *ts, uint64_t t) {
+    size_t removed = ts_lower_bound(ts, t);
+    ts->count -= removed;  // Tail is derived from head and count
+    return removed;
+}
+
+static inline bool ts_is_empty(ts_ring_t *ts) {
+    return ts->count == 0;
+}
+
+static inline size_t ts_size(ts_ring_t *ts) {
+    return ts->count;
+}
+
+static inline size_t ts_dropped_count(ts_ring_t *ts) {
+    return ts->dropped;
+}
+
+#endif
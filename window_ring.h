@@ -0,0 +1,228 @@
+// Sliding-window ring - keeps the last window samples of a numeric stream together with
+// their rolling sum, mean, min and max.
+// Re-scanning a buffer for these on every new sample costs O(window) per sample. Here the
+// sum is updated as samples enter and leave (O(1)), and min/max come from monotonic
+// queues: each queue only keeps the samples that can still become the extreme of the
+// window, so every sample is added and removed once (amortised O(1)).
+// Samples live in a ring<T, N>; window can be changed at run time up to N. A resize
+// recomputes the sum in bulk with SSE2 for float/double/int32_t (scalar otherwise) and
+// rebuilds the queues in one pass.
+// Floating-point sums drift slowly under repeated add/subtract - resize(window()) starts
+// a fresh, exact sum if that matters.
+#ifndef WINDOW_RING_H
+#define WINDOW_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <type_traits>
+#include "ring.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// Bulk sums used by window_ring::resize - generic version
+template <typename S, typename T>
+static inline S window_sum_span(const T *data, size_t len) {
+    S sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum += (S)data[i];
+    }
+    return sum;
+}
+
+#if defined(__SSE2__)
+template <>
+inline double window_sum_span<double, double>(const double *data, size_t len) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();  // Two accumulators hide the add latency
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    double sum = lanes[0] + lanes[1];
+    for (; i < len; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Floats are widened to double so the window sum keeps its precision
+template <>
+inline double window_sum_span<double, float>(const float *data, size_t len) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m128 chunk = _mm_loadu_ps(data + i);
+        acc0 = _mm_add_pd(acc0, _mm_cvtps_pd(chunk));
+        acc1 = _mm_add_pd(acc1, _mm_cvtps_pd(_mm_movehl_ps(chunk, chunk)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    double sum = lanes[0] + lanes[1];
+    for (; i < len; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// int32_t samples are sign-extended to 64-bit lanes so the sum cannot overflow
+template <>
+inline int64_t window_sum_span<int64_t, int32_t>(const int32_t *data, size_t len) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i sign = _mm_srai_epi32(chunk, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(chunk, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(chunk, sign));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    int64_t sum = lanes[0] + lanes[1];
+    for (; i < len; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+#endif
+
+template <typename T, size_t N>
+class window_ring {
+    static_assert(std::is_arithmetic<T>::value, "window_ring needs a numeric sample type");
+
+public:
+    // Accumulator: double for floating point, 64-bit integers otherwise
+    typedef typename conditional<is_floating_point<T>::value, double,
+            typename conditional<is_signed<T>::value, int64_t, uint64_t>::type>::type sum_type;
+
+    explicit window_ring(size_t window = N) : width((window == 0 || window > N) ? N : window), total(0), sequence(0) {
+        lows.clear();
+        highs.clear();
+    }
+
+    // Adds a sample, dropping the oldest one when the window is full
+    void push(T value) {
+        if (samples.size() == width) {
+            evict_oldest();
+        }
+        samples.push(value);
+        total += (sum_type)value;
+        lows.push_back(value, sequence, true);
+        highs.push_back(value, sequence, false);
+        sequence++;
+    }
+
+    // Rolling aggregates - min/max/mean need at least one sample
+    T min() const { return lows.front_value(); }
+    T max() const { return highs.front_value(); }
+    sum_type sum() const { return total; }
+    double mean() const { return (double)total / (double)samples.size(); }
+
+    // Changes the window length (1..N). Shrinking drops the oldest samples; the sum and the
+    // min/max queues are then recomputed from the samples that remain.
+    bool resize(size_t window) {
+        if (window == 0 || window > N) {
+            return false;
+        }
+        width = window;
+        while (samples.size() > width) {
+            samples.pop();
+        }
+        recompute();
+        return true;
+    }
+
+    void clear() {
+        samples.clear();
+        lows.clear();
+        highs.clear();
+        total = 0;
+    }
+
+    // i-th sample counting from the oldest (i < size())
+    T operator[](size_t i) const { return samples[i]; }
+    bool empty() const { return samples.empty(); }
+    size_t size() const { return samples.size(); }
+    size_t window() const { return width; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    // Monotonic queue of (value, sequence) in a fixed array. For the min queue values rise
+    // from front to back, for the max queue they fall; the front is the window's extreme.
+    struct extremum_queue {
+        T values[N];
+        uint64_t sequences[N];
+        size_t first;
+        size_t count;
+
+        void clear() { first = count = 0; }
+        T front_value() const { return values[first]; }
+        uint64_t front_sequence() const { return sequences[first]; }
+        void pop_front() {
+            first = (first + 1 == N) ? 0 : first + 1;
+            count--;
+        }
+        // Samples that can never be the extreme again (an equal or better value arrived
+        // later) are dropped from the back before the new one is added
+        void push_back(T value, uint64_t sequence, bool keep_low) {
+            while (count > 0) {
+                size_t back = (first + count - 1) % N;
+                if (keep_low ? (values[back] < value) : (values[back] > value)) {
+                    break;
+                }
+                count--;
+            }
+            size_t slot = (first + count) % N;
+            values[slot] = value;
+            sequences[slot] = sequence;
+            count++;
+        }
+    };
+
+    void evict_oldest() {
+        uint64_t oldest = sequence - samples.size();
+        T value = 0;
+        samples.pop(value);
+        total -= (sum_type)value;
+        if (lows.count > 0 && lows.front_sequence() == oldest) {
+            lows.pop_front();
+        }
+        if (highs.count > 0 && highs.front_sequence() == oldest) {
+            highs.pop_front();
+        }
+    }
+
+    // Bulk pass over the (at most two) contiguous spans of the ring
+    void recompute() {
+        total = 0;
+        lows.clear();
+        highs.clear();
+        uint64_t seq = sequence - samples.size();
+        size_t i = 0;
+        while (i < samples.size()) {
+            size_t len;
+            const T *data = samples.span(i, len);
+            total += window_sum_span<sum_type, T>(data, len);
+            for (size_t k = 0; k < len; k++, seq++) {
+                lows.push_back(data[k], seq, true);
+                highs.push_back(data[k], seq, false);
+            }
+            i += len;
+        }
+    }
+
+    ring<T, N> samples;     // The last width samples, oldest first
+    size_t width;           // Current window length (<= N)
+    sum_type total;         // Sum of the samples in the window
+    uint64_t sequence;      // Number of samples ever pushed
+    extremum_queue lows;    // Candidates for the minimum
+    extremum_queue highs;   // Candidates for the maximum
+};
+
+#endif
@@ -0,0 +1,128 @@
+// Work-Stealing Deque (Chase-Lev) - the per-worker task queue of a work-stealing scheduler.
+// Each worker thread owns one deque: it pushes and pops its own tasks at the bottom (LIFO,
+// so the most recent - cache-hot - task runs next), while idle workers steal from the top
+// (FIFO, the oldest and usually largest pieces of work).
+// The owner's push and pop touch only the bottom index and need no read-modify-write
+// atomics; a compare-and-swap on top is needed only when a thief steals, or when the
+// owner takes the very last task and may be racing a thief for it. Memory orders follow
+// the C11 formulation of the algorithm by Le, Pop, Cohen and Zappa Nardelli (PPoPP 2013).
+// Fixed capacity in caller-provided memory (no growth): wsd_push returns false when the
+// deque is full and the owner should then simply run the task itself.
+// Tasks are void * - a pointer to a task struct, or an index cast to a pointer.
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+using namespace std;
+
+#ifndef WSD_CACHE_LINE_SIZE
+#define WSD_CACHE_LINE_SIZE 64
+#endif
+
+typedef struct {
+    // Read-only after init
+    void **slots;       // Caller-provided array of capacity task pointers
+    size_t capacity;    // Power of two
+    size_t mask;        // capacity - 1
+
+    // Thieves contend on top, the owner works on bottom - different lines
+    alignas(WSD_CACHE_LINE_SIZE) int64_t top;     // Oldest task (steal end)
+    alignas(WSD_CACHE_LINE_SIZE) int64_t bottom;  // One past the newest task (owner end)
+} ws_deque_t;
+
+// Function Declarations:
+// capacity must be a power of two (>= 2), returns false otherwise.
+// Must be called before any thread uses the deque.
+static inline bool wsd_init(ws_deque_t *dq, void **slots, size_t capacity);
+// Owner thread only: add a task at the bottom (false when full), take the newest task back
+// (false when empty, or when a thief got the last one first)
+static inline bool wsd_push(ws_deque_t *dq, void *task);
+static inline bool wsd_pop(ws_deque_t *dq, void **task);
+// Any other thread: take the oldest task - false when the deque is empty
+static inline bool wsd_steal(ws_deque_t *dq, void **task);
+// Snapshot only - other threads may change it immediately
+static inline size_t wsd_size_approx(ws_deque_t *dq);
+
+// Helper Functions:
+static inline void **wsd_slot(ws_deque_t *dq, int64_t index) {
+    return &dq->slots[(size_t)index & dq->mask];
+}
+
+// Function Implementations:
+static inline bool wsd_init(ws_deque_t *dq, void **slots, size_t capacity) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return false;  // Not a power of two
+    }
+    dq->slots = slots;
+    dq->capacity = capacity;
+    dq->mask = capacity - 1;
+    dq->top = 0;
+    dq->bottom = 0;
+    return true;
+}
+
+static inline bool wsd_push(ws_deque_t *dq, void *task) {
+    int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    if (b - t >= (int64_t)dq->capacity) {
+        return false;  // Full - a slot is only reused once top has moved past it
+    }
+    __atomic_store_n(wsd_slot(dq, b), task, __ATOMIC_RELAXED);
+    // Publishes the task: a thief that sees the new bottom also sees the slot
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Claims the bottom slot first by lowering bottom, then looks at top. The seq_cst fence
+// pairs with the one in wsd_steal: either the thief sees the lowered bottom, or the owner
+// sees the thief's top - they cannot both take the same task unnoticed.
+static inline bool wsd_pop(ws_deque_t *dq, void **task) {
+    int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);  // Was empty - undo
+        return false;
+    }
+    *task = __atomic_load_n(wsd_slot(dq, b), __ATOMIC_RELAXED);
+    if (t < b) {
+        return true;  // More than one task left: no thief can reach this one
+    }
+    // Last task: race the thieves for it on top
+    bool won = __atomic_compare_exchange_n(&dq->top, &t, t + 1, false,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);  // Empty either way
+    return won;
+}
+
+// A failed CAS means another thread took the top task - that thread made progress, so
+// retrying keeps the deque lock-free and false always means "seen empty".
+static inline bool wsd_steal(ws_deque_t *dq, void **task) {
+    for (;;) {
+        int64_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+        if (t >= b) {
+            return false;
+        }
+        // Read before the CAS: once top moves on, the owner may reuse the slot
+        void *candidate = __atomic_load_n(wsd_slot(dq, t), __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&dq->top, &t, t + 1, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            *task = candidate;
+            return true;
+        }
+    }
+}
+
+static inline size_t wsd_size_approx(ws_deque_t *dq) {
+    int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+    return (b > t) ? (size_t)(b - t) : 0;
+}
+
+#endif